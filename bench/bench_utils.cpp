@@ -0,0 +1,280 @@
+#include "bench_utils.hpp"
+
+#include <glm/glm.hpp>
+
+#include "constants.hpp"
+#include "content/Content.hpp"
+#include "content/ContentBuilder.hpp"
+#include "content/ContentPack.hpp"
+#include "core_defs.hpp"
+#include "files/WorldFiles.hpp"
+#include "files/engine_paths.hpp"
+#include "items/ItemDef.hpp"
+#include "lighting/Lighting.hpp"
+#include "logic/scripting/lua/lua_engine.hpp"
+#include "maths/Heightmap.hpp"
+#include "objects/EntityDef.hpp"
+#include "objects/rigging.hpp"
+#include "settings.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/ChunksStorage.hpp"
+#include "world/Level.hpp"
+#include "world/World.hpp"
+#include "world/generator/GeneratorDef.hpp"
+
+using namespace bench;
+
+static const std::string CAMERAS[] {
+    "core:first-person",
+    "core:third-person-front",
+    "core:third-person-back",
+};
+
+static float terrain_height(float x, float z) {
+    return 0.35f + glm::sin(x * 0.031f) * glm::cos(z * 0.027f) * 0.12f +
+           glm::sin((x + z) * 0.11f) * 0.03f;
+}
+
+static uint32_t hash(int x, int y, int z) {
+    uint32_t h = x * 73856093u ^ y * 19349663u ^ z * 83492791u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    return h ^ (h >> 15);
+}
+
+/// @brief Generator script producing the same terrain as fill_terrain
+/// without Lua state
+class NativeGeneratorScript : public GeneratorScript {
+public:
+    void initialize(uint64_t) override {
+    }
+
+    std::shared_ptr<Heightmap> generateHeightmap(
+        const glm::ivec2& offset,
+        const glm::ivec2& size,
+        uint bpd,
+        const std::vector<std::shared_ptr<Heightmap>>&
+    ) override {
+        auto map = std::make_shared<Heightmap>(size.x, size.y);
+        auto values = map->getValues();
+        for (int z = 0; z < size.y; z++) {
+            for (int x = 0; x < size.x; x++) {
+                values[z * size.x + x] = terrain_height(
+                    offset.x + x * static_cast<int>(bpd),
+                    offset.y + z * static_cast<int>(bpd)
+                );
+            }
+        }
+        return map;
+    }
+
+    std::vector<std::shared_ptr<Heightmap>> generateParameterMaps(
+        const glm::ivec2&, const glm::ivec2&, uint
+    ) override {
+        return {};
+    }
+
+    std::vector<Placement> placeStructuresWide(
+        const glm::ivec2&, const glm::ivec2&, uint
+    ) override {
+        return {};
+    }
+
+    std::vector<Placement> placeStructures(
+        const glm::ivec2&,
+        const glm::ivec2&,
+        const std::shared_ptr<Heightmap>&,
+        uint
+    ) override {
+        return {};
+    }
+};
+
+fs::path bench::get_resources_folder() {
+    return fs::u8path(VOXELENGINE_RES_DIR);
+}
+
+TempDirectory::TempDirectory(const std::string& name)
+    : path(fs::temp_directory_path() / fs::u8path("voxelengine-bench-" + name)) {
+    fs::remove_all(path);
+    fs::create_directories(path);
+}
+
+TempDirectory::~TempDirectory() {
+    std::error_code ec;
+    fs::remove_all(path, ec);
+}
+
+static Block& create_block(ContentBuilder& builder, const std::string& name) {
+    auto& block = builder.blocks.create(name);
+    auto& item = builder.items.create(name + BLOCK_ITEM_SUFFIX);
+    item.placingBlock = name;
+    return block;
+}
+
+std::unique_ptr<Content> bench::create_content() {
+    EnginePaths paths;
+    paths.setResourcesFolder(get_resources_folder());
+
+    ContentBuilder builder;
+    corecontent::setup(&paths, &builder);
+
+    create_block(builder, STONE);
+    create_block(builder, DIRT);
+    create_block(builder, GRASS);
+    {
+        auto& block = create_block(builder, GLASS);
+        block.drawGroup = 2;
+        block.lightPassing = true;
+        block.skyLightPassing = true;
+    }
+    {
+        auto& block = create_block(builder, LAMP);
+        block.emission[0] = 15;
+        block.emission[1] = 14;
+        block.emission[2] = 13;
+    }
+    {
+        auto& block = create_block(builder, FLOWER);
+        block.model = BlockModel::xsprite;
+        block.lightPassing = true;
+        block.skyLightPassing = true;
+        block.obstacle = false;
+    }
+    for (const auto& camera : CAMERAS) {
+        builder.resourceIndices[static_cast<size_t>(ResourceType::CAMERA)].add(
+            camera, nullptr
+        );
+    }
+    builder.add(std::make_unique<rigging::SkeletonConfig>(
+        ENTITY,
+        std::make_unique<rigging::Bone>(
+            0, "root", "", std::vector<std::unique_ptr<rigging::Bone>> {},
+            glm::vec3(0.0f)
+        ),
+        1
+    ));
+    builder.entities.create(ENTITY);
+
+    auto& generator = builder.generators.create(GENERATOR);
+    generator.script = std::make_unique<NativeGeneratorScript>();
+    generator.seaLevel = 64;
+
+    Biome biome {};
+    biome.name = "plains";
+    biome.plants = BiomeElementList({WeightedEntry {FLOWER, 1.0f, {}}}, 0.05f);
+    biome.groundLayers = BlocksLayers {
+        {
+            BlocksLayer {GRASS, 1, false, {}},
+            BlocksLayer {DIRT, 3, false, {}},
+            BlocksLayer {STONE, -1, true, {}},
+        },
+        0
+    };
+    biome.seaLayers = BlocksLayers {{BlocksLayer {GLASS, -1, true, {}}}, 0};
+    generator.biomes.push_back(std::move(biome));
+
+    return builder.build();
+}
+
+void bench::fill_terrain(
+    const Content& content, voxel* voxels, int chunkX, int chunkZ
+) {
+    auto stone = content.blocks.require(STONE).rt.id;
+    auto dirt = content.blocks.require(DIRT).rt.id;
+    auto grass = content.blocks.require(GRASS).rt.id;
+    auto glass = content.blocks.require(GLASS).rt.id;
+    auto lamp = content.blocks.require(LAMP).rt.id;
+    auto flower = content.blocks.require(FLOWER).rt.id;
+
+    for (int z = 0; z < CHUNK_D; z++) {
+        for (int x = 0; x < CHUNK_W; x++) {
+            int gx = chunkX * CHUNK_W + x;
+            int gz = chunkZ * CHUNK_D + z;
+            int height = terrain_height(gx, gz) * CHUNK_H;
+            for (int y = 0; y < CHUNK_H; y++) {
+                auto& vox = voxels[vox_index(x, y, z)];
+                vox = voxel {BLOCK_AIR, {}};
+                uint32_t rand = hash(gx, y, gz);
+                if (y > height) {
+                    if (y == height + 1 && rand % 16 == 0) {
+                        vox.id = flower;
+                    }
+                    continue;
+                }
+                if (y < height - 4 && rand % 7 == 0) {
+                    // caves
+                    continue;
+                }
+                if (y == height) {
+                    vox.id = rand % 97 == 0 ? glass : grass;
+                } else if (y > height - 4) {
+                    vox.id = dirt;
+                } else {
+                    vox.id = rand % 211 == 0 ? lamp : stone;
+                }
+            }
+        }
+    }
+}
+
+std::unique_ptr<Level> bench::create_level(
+    const Content& content, EngineSettings& settings, const fs::path& directory
+) {
+    settings.chunks.loadDistance.set(3);
+    settings.chunks.padding.set(1);
+
+    WorldInfo info {};
+    info.name = "bench";
+    info.generator = GENERATOR;
+    info.seed = 0;
+    auto worldFiles = std::make_shared<WorldFiles>(directory);
+    auto world = std::make_unique<World>(
+        std::move(info), worldFiles, &content, std::vector<ContentPack> {}
+    );
+    auto level = std::make_unique<Level>(std::move(world), &content, settings);
+    level->chunks->setCenter(0, 0);
+    return level;
+}
+
+void bench::fill_level(Level& level, int radius) {
+    for (int z = -radius; z <= radius; z++) {
+        for (int x = -radius; x <= radius; x++) {
+            auto chunk = level.chunksStorage->create(x, z);
+            fill_terrain(*level.content, chunk->voxels, x, z);
+            chunk->updateHeights();
+            chunk->flags.loaded = true;
+            chunk->flags.ready = true;
+            level.chunks->putChunk(chunk);
+            Lighting::prebuildSkyLight(
+                chunk.get(), level.content->getIndices()
+            );
+        }
+    }
+    for (int z = -radius + 1; z < radius; z++) {
+        for (int x = -radius + 1; x < radius; x++) {
+            level.lighting->buildSkyLight(x, z);
+            level.lighting->onChunkLoaded(x, z, true);
+            level.chunks->getChunk(x, z)->flags.lighted = true;
+        }
+    }
+}
+
+void bench::init_scripting() {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    EnginePaths paths;
+    paths.setResourcesFolder(get_resources_folder());
+    lua::initialize(paths);
+
+    // minimal replacement of stdlib entities support (no components)
+    auto L = lua::get_main_state();
+    lua::pop(L, lua::execute(
+        L, 0, "stdcomp = {new_Entity = function(eid) return {eid=eid} end}"
+    ));
+    initialized = true;
+}
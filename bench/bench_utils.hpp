@@ -0,0 +1,68 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "typedefs.hpp"
+
+namespace fs = std::filesystem;
+
+class Content;
+class Level;
+struct EngineSettings;
+struct voxel;
+
+/// @brief Headless environment for benchmarks: synthetic content, terrain
+/// and level created without window, assets and scripting
+namespace bench {
+    inline const std::string STONE = "bench:stone";
+    inline const std::string DIRT = "bench:dirt";
+    inline const std::string GRASS = "bench:grass";
+    inline const std::string GLASS = "bench:glass";
+    inline const std::string LAMP = "bench:lamp";
+    inline const std::string FLOWER = "bench:flower";
+    inline const std::string ENTITY = "bench:entity";
+    inline const std::string GENERATOR = "bench:default";
+
+    /// @brief Engine resources folder (res/ of the source tree)
+    fs::path get_resources_folder();
+
+    /// @brief Temporary directory removed with all its content on destruction
+    class TempDirectory {
+        fs::path path;
+    public:
+        TempDirectory(const std::string& name);
+        ~TempDirectory();
+
+        const fs::path& get() const {
+            return path;
+        }
+    };
+
+    /// @brief Create content with core blocks, a few bench blocks
+    /// (solid, transparent, emissive, X-sprite), an entity and a
+    /// generator with native (C++) script and the base generator layers
+    std::unique_ptr<Content> create_content();
+
+    /// @brief Fill chunk voxels with deterministic hilly terrain with caves,
+    /// plants, glass and lamps
+    void fill_terrain(
+        const Content& content, voxel* voxels, int chunkX, int chunkZ
+    );
+
+    /// @brief Create level with world files in the given directory.
+    /// Chunks matrix is centered at 0, 0
+    std::unique_ptr<Level> create_level(
+        const Content& content,
+        EngineSettings& settings,
+        const fs::path& directory
+    );
+
+    /// @brief Create level chunks in the square [-radius, radius],
+    /// fill them with terrain and build lights
+    void fill_level(Level& level, int radius);
+
+    /// @brief Initialize main Lua state required to spawn entities
+    void init_scripting();
+}
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include "coders/binary_json.hpp"
+
+/// @brief Object shaped like saved entities data
+static dv::value create_entities(int count) {
+    auto root = dv::object();
+    auto& list = root.list("data");
+    for (int i = 0; i < count; i++) {
+        auto& entity = list.object();
+        entity["def"] = "base:drop";
+        entity["uid"] = i;
+        auto& comps = entity.object("comps");
+        auto& transform = comps.object("transform");
+        auto& pos = transform.list("pos");
+        pos.add(i * 0.5);
+        pos.add(64.0);
+        pos.add(-i * 0.25);
+        transform["size"] = dv::list({1.0, 1.0, 1.0});
+        auto& body = comps.object("rigidbody");
+        body["enabled"] = true;
+        body["vel"] = dv::list({0.0, -9.8, 0.0});
+        auto& data = comps.object("base:drop");
+        data["item"] = "base:stone.item";
+        data["count"] = 64;
+    }
+    return root;
+}
+
+static void BM_BinaryJsonEncode(benchmark::State& state) {
+    auto value = create_entities(state.range(0));
+    for (auto _ : state) {
+        auto bytes = json::to_binary(value);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinaryJsonEncode)->Arg(16)->Arg(1024);
+
+static void BM_BinaryJsonDecode(benchmark::State& state) {
+    auto bytes = json::to_binary(create_entities(state.range(0)));
+    for (auto _ : state) {
+        auto value = json::from_binary(bytes.data(), bytes.size());
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinaryJsonDecode)->Arg(16)->Arg(1024);
+
+static void BM_BinaryJsonDecodeArena(benchmark::State& state) {
+    auto bytes = json::to_binary(create_entities(state.range(0)));
+    for (auto _ : state) {
+        dv::ArenaScope arena;
+        auto value = json::from_binary(bytes.data(), bytes.size());
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinaryJsonDecodeArena)->Arg(16)->Arg(1024);
+
+static void BM_BinaryJsonRoundTripCompressed(benchmark::State& state) {
+    auto value = create_entities(state.range(0));
+    for (auto _ : state) {
+        auto bytes = json::to_binary(value, true);
+        auto decoded = json::from_binary(bytes.data(), bytes.size());
+        benchmark::DoNotOptimize(decoded);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinaryJsonRoundTripCompressed)->Arg(1024);
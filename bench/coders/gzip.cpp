@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+
+#include "../bench_utils.hpp"
+#include "coders/gzip.hpp"
+#include "content/Content.hpp"
+#include "voxels/Chunk.hpp"
+
+static std::unique_ptr<ubyte[]> encoded_chunk() {
+    static auto content = bench::create_content();
+    Chunk chunk(0, 0);
+    bench::fill_terrain(*content, chunk.voxels, 0, 0);
+    return chunk.encode();
+}
+
+static void BM_GzipCompress(benchmark::State& state) {
+    auto src = encoded_chunk();
+    size_t size = 0;
+    for (auto _ : state) {
+        auto bytes = gzip::compress(src.get(), CHUNK_DATA_LEN);
+        size = bytes.size();
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+    state.counters["ratio"] = static_cast<double>(CHUNK_DATA_LEN) / size;
+}
+BENCHMARK(BM_GzipCompress);
+
+static void BM_GzipDecompress(benchmark::State& state) {
+    auto src = encoded_chunk();
+    auto compressed = gzip::compress(src.get(), CHUNK_DATA_LEN);
+    for (auto _ : state) {
+        auto bytes = gzip::decompress(compressed.data(), compressed.size());
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+}
+BENCHMARK(BM_GzipDecompress);
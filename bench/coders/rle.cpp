@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include "../bench_utils.hpp"
+#include "coders/rle.hpp"
+#include "content/Content.hpp"
+#include "voxels/Chunk.hpp"
+
+static std::unique_ptr<ubyte[]> encoded_chunk() {
+    static auto content = bench::create_content();
+    Chunk chunk(0, 0);
+    bench::fill_terrain(*content, chunk.voxels, 0, 0);
+    return chunk.encode();
+}
+
+static void BM_ExtRleEncode(benchmark::State& state) {
+    auto src = encoded_chunk();
+    auto dst = std::make_unique<ubyte[]>(CHUNK_DATA_LEN * 2);
+    size_t size = 0;
+    for (auto _ : state) {
+        size = extrle::encode(src.get(), CHUNK_DATA_LEN, dst.get());
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+    state.counters["ratio"] = static_cast<double>(CHUNK_DATA_LEN) / size;
+}
+BENCHMARK(BM_ExtRleEncode);
+
+static void BM_ExtRleDecode(benchmark::State& state) {
+    auto src = encoded_chunk();
+    auto encoded = std::make_unique<ubyte[]>(CHUNK_DATA_LEN * 2);
+    size_t size = extrle::encode(src.get(), CHUNK_DATA_LEN, encoded.get());
+    auto dst = std::make_unique<ubyte[]>(CHUNK_DATA_LEN);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(extrle::decode(encoded.get(), size, dst.get()));
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+}
+BENCHMARK(BM_ExtRleDecode);
+
+static void BM_ExtRle16Encode(benchmark::State& state) {
+    auto src = encoded_chunk();
+    auto dst = std::make_unique<ubyte[]>(CHUNK_DATA_LEN * 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            extrle::encode16(src.get(), CHUNK_DATA_LEN, dst.get())
+        );
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+}
+BENCHMARK(BM_ExtRle16Encode);
+
+static void BM_ExtRle16Decode(benchmark::State& state) {
+    auto src = encoded_chunk();
+    auto encoded = std::make_unique<ubyte[]>(CHUNK_DATA_LEN * 2);
+    size_t size = extrle::encode16(src.get(), CHUNK_DATA_LEN, encoded.get());
+    auto dst = std::make_unique<ubyte[]>(CHUNK_DATA_LEN);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            extrle::decode16(encoded.get(), size, dst.get())
+        );
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+}
+BENCHMARK(BM_ExtRle16Decode);
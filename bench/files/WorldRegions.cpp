@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include "../bench_utils.hpp"
+#include "content/Content.hpp"
+#include "files/WorldRegions.hpp"
+#include "voxels/Chunk.hpp"
+
+static constexpr int CHUNKS_SIDE = 8;
+
+static void write_chunks(
+    WorldRegions& regions, const std::vector<std::unique_ptr<Chunk>>& chunks
+) {
+    for (const auto& chunk : chunks) {
+        chunk->flags.unsaved = true;
+        regions.put(chunk.get(), {});
+    }
+    regions.writeAll();
+}
+
+static std::vector<std::unique_ptr<Chunk>> create_chunks() {
+    auto content = bench::create_content();
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (int z = 0; z < CHUNKS_SIDE; z++) {
+        for (int x = 0; x < CHUNKS_SIDE; x++) {
+            auto chunk = std::make_unique<Chunk>(x, z);
+            bench::fill_terrain(*content, chunk->voxels, x, z);
+            chunk->flags.lighted = true;
+            chunks.push_back(std::move(chunk));
+        }
+    }
+    return chunks;
+}
+
+static void BM_RegionsWrite(benchmark::State& state) {
+    bench::TempDirectory directory("regions-write");
+    auto chunks = create_chunks();
+    for (auto _ : state) {
+        WorldRegions regions(directory.get());
+        write_chunks(regions, chunks);
+    }
+    state.SetItemsProcessed(state.iterations() * chunks.size());
+}
+BENCHMARK(BM_RegionsWrite)->Unit(benchmark::kMillisecond);
+
+static void BM_RegionsRead(benchmark::State& state) {
+    bench::TempDirectory directory("regions-read");
+    {
+        WorldRegions regions(directory.get());
+        write_chunks(regions, create_chunks());
+    }
+    for (auto _ : state) {
+        WorldRegions regions(directory.get());
+        for (int z = 0; z < CHUNKS_SIDE; z++) {
+            for (int x = 0; x < CHUNKS_SIDE; x++) {
+                auto voxels = regions.getVoxels(x, z);
+                auto lights = regions.getLights(x, z);
+                benchmark::DoNotOptimize(voxels.get());
+                benchmark::DoNotOptimize(lights.get());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * CHUNKS_SIDE * CHUNKS_SIDE);
+}
+BENCHMARK(BM_RegionsRead)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include "../../bench_utils.hpp"
+#include "assets/Assets.hpp"
+#include "content/Content.hpp"
+#include "frontend/ContentGfxCache.hpp"
+#include "graphics/core/Atlas.hpp"
+#include "graphics/core/ImageData.hpp"
+#include "graphics/render/BlocksRenderer.hpp"
+#include "settings.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "world/Level.hpp"
+
+static void BM_BlocksRendererBuild(benchmark::State& state) {
+    bench::TempDirectory directory("meshing");
+    auto content = bench::create_content();
+    EngineSettings settings;
+    auto level = bench::create_level(*content, settings, directory.get());
+    bench::fill_level(*level, 1);
+
+    // atlas is not uploaded to GPU (prepare = false)
+    Assets assets;
+    assets.store(
+        std::make_unique<Atlas>(
+            std::make_unique<ImageData>(ImageFormat::rgba8888, 16, 16),
+            std::unordered_map<std::string, UVRegion> {},
+            false
+        ),
+        "blocks"
+    );
+    ContentGfxCache cache(content.get(), assets);
+    BlocksRenderer renderer(
+        settings.graphics.chunkMaxVertices.get(), *content, cache, settings
+    );
+    ChunkSnapshot snapshot;
+    renderer.takeSnapshot(*level->chunks->getChunk(0, 0), *level->chunks, snapshot);
+
+    for (auto _ : state) {
+        renderer.build(snapshot);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_BlocksRendererBuild)->Unit(benchmark::kMillisecond);
+
+static void BM_BlocksRendererSnapshot(benchmark::State& state) {
+    bench::TempDirectory directory("snapshot");
+    auto content = bench::create_content();
+    EngineSettings settings;
+    auto level = bench::create_level(*content, settings, directory.get());
+    bench::fill_level(*level, 1);
+
+    Assets assets;
+    assets.store(
+        std::make_unique<Atlas>(
+            std::make_unique<ImageData>(ImageFormat::rgba8888, 16, 16),
+            std::unordered_map<std::string, UVRegion> {},
+            false
+        ),
+        "blocks"
+    );
+    ContentGfxCache cache(content.get(), assets);
+    BlocksRenderer renderer(
+        settings.graphics.chunkMaxVertices.get(), *content, cache, settings
+    );
+    ChunkSnapshot snapshot;
+    const auto& chunk = *level->chunks->getChunk(0, 0);
+    for (auto _ : state) {
+        renderer.takeSnapshot(chunk, *level->chunks, snapshot);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_BlocksRendererSnapshot);
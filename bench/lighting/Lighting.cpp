@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+
+#include "../bench_utils.hpp"
+#include "content/Content.hpp"
+#include "lighting/Lighting.hpp"
+#include "settings.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "world/Level.hpp"
+
+static void BM_LightingOnChunkLoaded(benchmark::State& state) {
+    bench::TempDirectory directory("lighting");
+    auto content = bench::create_content();
+    EngineSettings settings;
+    auto level = bench::create_level(*content, settings, directory.get());
+    bench::fill_level(*level, 1);
+
+    auto& lighting = *level->lighting;
+    for (auto _ : state) {
+        state.PauseTiming();
+        lighting.clear();
+        for (int z = -1; z <= 1; z++) {
+            for (int x = -1; x <= 1; x++) {
+                Lighting::prebuildSkyLight(
+                    level->chunks->getChunk(x, z), content->getIndices()
+                );
+            }
+        }
+        lighting.buildSkyLight(0, 0);
+        state.ResumeTiming();
+
+        lighting.onChunkLoaded(0, 0, true);
+    }
+}
+BENCHMARK(BM_LightingOnChunkLoaded)->Unit(benchmark::kMillisecond);
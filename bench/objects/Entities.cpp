@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include "../bench_utils.hpp"
+#include "content/Content.hpp"
+#include "logic/scripting/lua/lua_engine.hpp"
+#include "maths/aabb.hpp"
+#include "objects/Entities.hpp"
+#include "objects/EntityDef.hpp"
+#include "settings.hpp"
+#include "world/Level.hpp"
+
+static constexpr float SPAWN_AREA = 64.0f;
+
+static void spawn_entities(Level& level, int count) {
+    bench::init_scripting();
+    const auto& def = level.content->entities.require(bench::ENTITY);
+    auto L = lua::get_main_state();
+    for (int i = 0; i < count; i++) {
+        lua::stackguard _(L);
+        glm::vec3 pos(
+            (i * 37 % 1024) / 1024.0f * SPAWN_AREA,
+            64.0f + i % 8,
+            (i * 91 % 1024) / 1024.0f * SPAWN_AREA
+        );
+        level.entities->spawn(def, pos);
+    }
+}
+
+static void BM_EntitiesGetAllInside(benchmark::State& state) {
+    bench::TempDirectory directory("entities-inside");
+    auto content = bench::create_content();
+    EngineSettings settings;
+    auto level = bench::create_level(*content, settings, directory.get());
+    spawn_entities(*level, state.range(0));
+
+    AABB aabb(glm::vec3(16.0f, 60.0f, 16.0f), glm::vec3(32.0f, 70.0f, 32.0f));
+    for (auto _ : state) {
+        auto entities = level->entities->getAllInside(aabb);
+        benchmark::DoNotOptimize(entities.data());
+    }
+}
+BENCHMARK(BM_EntitiesGetAllInside)->Arg(256)->Arg(4096);
+
+static void BM_EntitiesGetAllInRadius(benchmark::State& state) {
+    bench::TempDirectory directory("entities-radius");
+    auto content = bench::create_content();
+    EngineSettings settings;
+    auto level = bench::create_level(*content, settings, directory.get());
+    spawn_entities(*level, state.range(0));
+
+    glm::vec3 center(32.0f, 64.0f, 32.0f);
+    for (auto _ : state) {
+        auto entities = level->entities->getAllInRadius(center, 8.0f);
+        benchmark::DoNotOptimize(entities.data());
+    }
+}
+BENCHMARK(BM_EntitiesGetAllInRadius)->Arg(256)->Arg(4096);
+
+static void BM_EntitiesRayCast(benchmark::State& state) {
+    bench::TempDirectory directory("entities-raycast");
+    auto content = bench::create_content();
+    EngineSettings settings;
+    auto level = bench::create_level(*content, settings, directory.get());
+    spawn_entities(*level, state.range(0));
+
+    glm::vec3 start(0.0f, 66.0f, 0.0f);
+    glm::vec3 dir = glm::normalize(glm::vec3(1.0f, 0.0f, 1.0f));
+    for (auto _ : state) {
+        auto result = level->entities->rayCast(start, dir, SPAWN_AREA);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_EntitiesRayCast)->Arg(256)->Arg(4096);
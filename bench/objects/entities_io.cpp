@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include "coders/binary_json.hpp"
+#include "data/dv_util.hpp"
+#include "objects/entities_io.hpp"
+
+static std::vector<SavedEntity> create_entities(int count) {
+    std::vector<SavedEntity> entities(count);
+    for (int i = 0; i < count; i++) {
+        auto& entity = entities[i];
+        entity.def = i % 2 ? "base:drop" : "base:falling_block";
+        entity.uid = i + 1;
+        entity.pos = glm::vec3(i * 0.5f, 64.0f, -i * 0.25f);
+        entity.size = glm::vec3(0.2f);
+        entity.velocity = glm::vec3(0.0f, -9.8f, 0.0f);
+        entity.damping = 1.0f;
+        entity.pose.resize(2, glm::mat4(1.0f));
+        entity.components = dv::object();
+        auto& drop = entity.components.object("base:drop");
+        drop["item"] = "base:stone.item";
+        drop["count"] = 64;
+    }
+    return entities;
+}
+
+/// @brief Same entities in the legacy binary json format
+static std::vector<ubyte> encode_legacy(
+    const std::vector<SavedEntity>& entities
+) {
+    auto root = dv::object();
+    auto& list = root.list("data");
+    for (const auto& entity : entities) {
+        auto& map = list.object();
+        map["def"] = entity.def;
+        map["uid"] = entity.uid;
+        auto& tsfmap = map.object(entities_io::COMP_TRANSFORM);
+        tsfmap["pos"] = dv::to_value(entity.pos);
+        tsfmap["size"] = dv::to_value(entity.size);
+        auto& bodymap = map.object(entities_io::COMP_RIGIDBODY);
+        bodymap["vel"] = dv::to_value(*entity.velocity);
+        bodymap["damping"] = *entity.damping;
+        auto& posearr = map.object(entities_io::COMP_SKELETON).list("pose");
+        for (const auto& matrix : entity.pose) {
+            posearr.add(dv::to_value(matrix));
+        }
+        map["comps"] = entity.components;
+    }
+    return json::to_binary(root, true);
+}
+
+static void BM_EntitiesEncode(benchmark::State& state) {
+    auto entities = create_entities(state.range(0));
+    for (auto _ : state) {
+        auto bytes = entities_io::encode(entities);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntitiesEncode)->Arg(256);
+
+static void BM_EntitiesDecode(benchmark::State& state) {
+    auto bytes = entities_io::encode(create_entities(state.range(0)));
+    for (auto _ : state) {
+        auto entities = entities_io::decode(bytes.data(), bytes.size());
+        benchmark::DoNotOptimize(entities.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntitiesDecode)->Arg(256);
+
+static void BM_EntitiesDecodeLegacy(benchmark::State& state) {
+    auto bytes = encode_legacy(create_entities(state.range(0)));
+    for (auto _ : state) {
+        auto entities = entities_io::decode(bytes.data(), bytes.size());
+        benchmark::DoNotOptimize(entities.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntitiesDecodeLegacy)->Arg(256);
+
+static void BM_EntitiesEncodeLegacy(benchmark::State& state) {
+    auto entities = create_entities(state.range(0));
+    for (auto _ : state) {
+        auto bytes = encode_legacy(entities);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntitiesEncodeLegacy)->Arg(256);
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "util/SmallHeap.hpp"
+
+using namespace util;
+
+static std::vector<uint16_t> shuffled_indices(size_t count) {
+    std::vector<uint16_t> indices(count);
+    for (size_t i = 0; i < count; i++) {
+        indices[i] = i * 7;
+    }
+    std::shuffle(indices.begin(), indices.end(), std::mt19937(0));
+    return indices;
+}
+
+static void BM_SmallHeapAllocate(benchmark::State& state) {
+    auto indices = shuffled_indices(state.range(0));
+    for (auto _ : state) {
+        SmallHeap<uint16_t, uint8_t> heap;
+        for (auto index : indices) {
+            benchmark::DoNotOptimize(heap.allocate(index, 8));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(BM_SmallHeapAllocate)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_SmallHeapFind(benchmark::State& state) {
+    auto indices = shuffled_indices(state.range(0));
+    SmallHeap<uint16_t, uint8_t> heap;
+    for (auto index : indices) {
+        heap.allocate(index, 8);
+    }
+    for (auto _ : state) {
+        for (auto index : indices) {
+            benchmark::DoNotOptimize(heap.find(index));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(BM_SmallHeapFind)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_SmallHeapFree(benchmark::State& state) {
+    auto indices = shuffled_indices(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        SmallHeap<uint16_t, uint8_t> heap;
+        for (auto index : indices) {
+            heap.allocate(index, 8);
+        }
+        state.ResumeTiming();
+        for (auto index : indices) {
+            heap.free(heap.find(index));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(BM_SmallHeapFree)->Arg(16)->Arg(256)->Arg(4096);
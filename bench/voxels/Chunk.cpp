@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+
+#include "../bench_utils.hpp"
+#include "content/Content.hpp"
+#include "voxels/Chunk.hpp"
+
+static void BM_ChunkEncode(benchmark::State& state) {
+    auto content = bench::create_content();
+    Chunk chunk(0, 0);
+    bench::fill_terrain(*content, chunk.voxels, 0, 0);
+    for (auto _ : state) {
+        auto bytes = chunk.encode();
+        benchmark::DoNotOptimize(bytes.get());
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+}
+BENCHMARK(BM_ChunkEncode);
+
+static void BM_ChunkDecode(benchmark::State& state) {
+    auto content = bench::create_content();
+    Chunk src(0, 0);
+    bench::fill_terrain(*content, src.voxels, 0, 0);
+    auto bytes = src.encode();
+    Chunk chunk(0, 0);
+    for (auto _ : state) {
+        chunk.decode(bytes.get());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+}
+BENCHMARK(BM_ChunkDecode);
@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include "../../bench_utils.hpp"
+#include "constants.hpp"
+#include "content/Content.hpp"
+#include "voxels/voxel.hpp"
+#include "world/generator/GeneratorDef.hpp"
+#include "world/generator/WorldGenerator.hpp"
+
+static void BM_WorldGeneratorGenerate(benchmark::State& state) {
+    auto content = bench::create_content();
+    const auto& def = content->generators.require(bench::GENERATOR);
+    auto voxels = std::make_unique<voxel[]>(CHUNK_VOL);
+
+    int radius = state.range(0);
+    int64_t chunks = 0;
+    for (auto _ : state) {
+        // new generator has no cached prototypes
+        state.PauseTiming();
+        WorldGenerator generator(def, content.get(), 0);
+        state.ResumeTiming();
+
+        generator.update(0, 0, radius + 1);
+        for (int z = -radius; z <= radius; z++) {
+            for (int x = -radius; x <= radius; x++) {
+                generator.generate(voxels.get(), x, z);
+                chunks++;
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(chunks);
+}
+BENCHMARK(BM_WorldGeneratorGenerate)->Arg(2)->Unit(benchmark::kMillisecond);
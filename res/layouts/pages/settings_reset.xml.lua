@@ -37,6 +37,7 @@ function reset_graphics()
     reset_setting("graphics.fog-curve")
     reset_setting("graphics.gamma")
     reset_setting("graphics.backlight")
+    reset_setting("graphics.greedy-meshing")
 end
 
 function reset_control()
@@ -256,6 +256,51 @@ console.add_command(
     end
 )
 
+console.add_command(
+    "profiler operation:[start|stop|reset|report|save] name:str='profile'",
+    "Control scripts profiler (save writes export:<name>.json and .folded)",
+    function(args, kwargs)
+        local operation = args[1]
+        if operation == "start" then
+            profiler.start()
+            return "profiler started"
+        elseif operation == "stop" then
+            profiler.stop()
+            return "profiler stopped"
+        elseif operation == "reset" then
+            profiler.reset()
+            return "profiler results cleared"
+        elseif operation == "report" then
+            return profiler.report()
+        end
+        local name = args[2]
+        local filename = "export:"..name
+        file.write(filename..".json", json.tostring(profiler.get_results(), true))
+        file.write(filename..".folded", profiler.get_folded())
+        return "profiler results have been saved as "..
+               file.resolve(filename..".json").." and "..
+               file.resolve(filename..".folded")
+    end
+)
+
+console.add_command(
+    "profiler.trace operation:[start|stop|save] name:str='trace'",
+    "Record engine trace (save writes export:<name>.json in Chrome trace format)",
+    function(args, kwargs)
+        local operation = args[1]
+        if operation == "start" then
+            profiler.trace_start()
+            return "trace recording started"
+        elseif operation == "stop" then
+            profiler.trace_stop()
+            return "trace recording stopped"
+        end
+        local filename = "export:"..args[2]..".json"
+        profiler.save_trace(filename)
+        return "trace has been saved as "..file.resolve(filename)
+    end
+)
+
 console.cheats = {
     "blocks.fill",
     "tp",
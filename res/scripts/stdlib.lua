@@ -12,10 +12,18 @@ end
 ------------------------------------------------
 ------------------- Events ---------------------
 ------------------------------------------------
+-- handler lists are modified in place: the engine keeps references to
+-- lists of block events to call handlers without name lookup
 events = {
     handlers = {}
 }
 
+local function clear_list(list)
+    for i=#list,1,-1 do
+        list[i] = nil
+    end
+end
+
 function events.on(event, func)
     if events.handlers[event] == nil then
         events.handlers[event] = {}
@@ -24,10 +32,16 @@ function events.on(event, func)
 end
 
 function events.reset(event, func)
-    if func == nil then
-        events.handlers[event] = nil
-    else
-        events.handlers[event] = {func}
+    local handlers = events.handlers[event]
+    if handlers == nil then
+        if func ~= nil then
+            events.handlers[event] = {func}
+        end
+        return
+    end
+    clear_list(handlers)
+    if func ~= nil then
+        table.insert(handlers, func)
     end
 end
 
@@ -38,7 +52,7 @@ function events.remove_by_prefix(prefix)
             actualname = name[1]
         end
         if actualname:sub(1, #prefix+1) == prefix..':' then
-            events.handlers[actualname] = nil
+            clear_list(handlers)
         end
     end
 end
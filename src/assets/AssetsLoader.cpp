@@ -1,7 +1,11 @@
 #include "AssetsLoader.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include "coders/imageio.hpp"
@@ -14,7 +18,9 @@
 #include "graphics/core/Texture.hpp"
 #include "logic/scripting/scripting.hpp"
 #include "objects/rigging.hpp"
+#include "util/JobSystem.hpp"
 #include "util/ThreadPool.hpp"
+#include "util/timeutil.hpp"
 #include "voxels/Block.hpp"
 #include "items/ItemDef.hpp"
 #include "Assets.hpp"
@@ -24,17 +30,23 @@ static debug::Logger logger("assets-loader");
 
 AssetsLoader::AssetsLoader(Assets* assets, const ResPaths* paths)
     : assets(assets), paths(paths) {
+    // shaders preprocessor caches headers, sounds use audio backend
     addLoader(AssetType::SHADER, assetload::shader);
-    addLoader(AssetType::TEXTURE, assetload::texture);
-    addLoader(AssetType::FONT, assetload::font);
-    addLoader(AssetType::ATLAS, assetload::atlas);
+    addLoader(AssetType::TEXTURE, assetload::texture, true);
+    addLoader(AssetType::FONT, assetload::font, true);
+    addLoader(AssetType::ATLAS, assetload::atlas, true);
     addLoader(AssetType::LAYOUT, assetload::layout);
     addLoader(AssetType::SOUND, assetload::sound);
-    addLoader(AssetType::MODEL, assetload::model);
+    addLoader(AssetType::MODEL, assetload::model, true);
 }
 
-void AssetsLoader::addLoader(AssetType tag, aloader_func func) {
+void AssetsLoader::addLoader(AssetType tag, aloader_func func, bool parallel) {
     loaders[tag] = std::move(func);
+    if (parallel) {
+        parallelLoaders.insert(tag);
+    } else {
+        parallelLoaders.erase(tag);
+    }
 }
 
 void AssetsLoader::add(
@@ -65,11 +77,18 @@ void AssetsLoader::loadNext() {
     logger.info() << "loading " << entry.filename << " as " << entry.alias;
     try {
         aloader_func loader = getLoader(entry.tag);
+        auto& typeStats = stats[entry.tag];
+        timeutil::Timer timer;
         auto postfunc =
             loader(this, paths, entry.filename, entry.alias, entry.config);
+        typeStats.decodeTime += timer.stop();
+
+        timeutil::Timer finalizeTimer;
         postfunc(assets);
+        typeStats.finalizeTime += finalizeTimer.stop();
+        typeStats.count++;
         entries.pop();
-    } catch (std::runtime_error& err) {
+    } catch (const std::exception& err) {
         logger.error() << err.what();
         auto type = entry.tag;
         std::string filename = entry.filename;
@@ -79,6 +98,193 @@ void AssetsLoader::loadNext() {
     }
 }
 
+namespace {
+    struct LoadResult {
+        assetload::postfunc postfunc;
+        int64_t decodeTime = 0;
+        std::string error;
+        bool failed = false;
+        bool done = false;
+    };
+
+    /// @brief Calls thread-safe loaders of a batch in the job system
+    class BatchDecoder {
+        AssetsLoader& loader;
+        const std::vector<aloader_entry>& batch;
+        const std::vector<bool>& parallel;
+        std::vector<LoadResult>& results;
+        util::JobGroup jobs;
+        std::atomic<size_t> next = 0;
+        std::atomic<bool> working = true;
+        std::mutex mutex;
+        std::condition_variable variable;
+
+        void decodeLoop() {
+            while (working) {
+                size_t index = next++;
+                if (index >= batch.size()) {
+                    break;
+                }
+                if (!parallel[index]) {
+                    continue;
+                }
+                const auto& entry = batch[index];
+                LoadResult result {};
+                timeutil::Timer timer;
+                try {
+                    auto func = loader.getLoader(entry.tag);
+                    result.postfunc = func(
+                        &loader,
+                        loader.getPaths(),
+                        entry.filename,
+                        entry.alias,
+                        entry.config
+                    );
+                } catch (const std::exception& err) {
+                    result.failed = true;
+                    result.error = err.what();
+                }
+                result.decodeTime = timer.stop();
+                result.done = true;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    results[index] = std::move(result);
+                }
+                variable.notify_all();
+            }
+        }
+    public:
+        BatchDecoder(
+            AssetsLoader& loader,
+            const std::vector<aloader_entry>& batch,
+            const std::vector<bool>& parallel,
+            std::vector<LoadResult>& results,
+            uint numJobs
+        )
+            : loader(loader),
+              batch(batch),
+              parallel(parallel),
+              results(results),
+              jobs(util::JobSystem::getDefault()) {
+            for (uint i = 0; i < numJobs; i++) {
+                jobs.add([this]() { decodeLoop(); });
+            }
+        }
+
+        ~BatchDecoder() {
+            working = false;
+            jobs.wait();
+        }
+
+        /// @brief Wait for the entry to be decoded by a worker
+        LoadResult take(size_t index) {
+            std::unique_lock<std::mutex> lock(mutex);
+            variable.wait(lock, [this, index] { return results[index].done; });
+            return std::move(results[index]);
+        }
+    };
+}
+
+static const char* asset_type_name(AssetType tag) {
+    switch (tag) {
+        case AssetType::TEXTURE:
+            return "textures";
+        case AssetType::SHADER:
+            return "shaders";
+        case AssetType::FONT:
+            return "fonts";
+        case AssetType::ATLAS:
+            return "atlases";
+        case AssetType::LAYOUT:
+            return "layouts";
+        case AssetType::SOUND:
+            return "sounds";
+        case AssetType::MODEL:
+            return "models";
+    }
+    return "<error>";
+}
+
+void AssetsLoader::loadBatch(std::vector<aloader_entry> batch, uint maxWorkers) {
+    std::vector<bool> parallel(batch.size());
+    size_t parallelCount = 0;
+    for (size_t i = 0; i < batch.size(); i++) {
+        parallel[i] = parallelLoaders.find(batch[i].tag) != parallelLoaders.end();
+        parallelCount += parallel[i];
+    }
+    uint numJobs = maxWorkers ? maxWorkers
+                              : util::JobSystem::getDefault().getThreadsCount();
+    numJobs = std::min(numJobs, static_cast<uint>(parallelCount));
+
+    std::vector<LoadResult> results(batch.size());
+    BatchDecoder decoder(*this, batch, parallel, results, numJobs);
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        const auto& entry = batch[i];
+        LoadResult result {};
+        if (parallel[i]) {
+            result = decoder.take(i);
+        } else {
+            timeutil::Timer timer;
+            try {
+                result.postfunc = getLoader(entry.tag)(
+                    this, paths, entry.filename, entry.alias, entry.config
+                );
+            } catch (const std::exception& err) {
+                result.failed = true;
+                result.error = err.what();
+            }
+            result.decodeTime = timer.stop();
+        }
+        logger.info() << "loading " << entry.filename << " as " << entry.alias;
+        auto& typeStats = stats[entry.tag];
+        typeStats.decodeTime += result.decodeTime;
+        if (!result.failed) {
+            timeutil::Timer timer;
+            try {
+                result.postfunc(assets);
+            } catch (const std::exception& err) {
+                result.failed = true;
+                result.error = err.what();
+            }
+            typeStats.finalizeTime += timer.stop();
+        }
+        if (result.failed) {
+            logger.error() << result.error;
+            throw assetload::error(
+                entry.tag, entry.filename, std::move(result.error)
+            );
+        }
+        typeStats.count++;
+    }
+}
+
+void AssetsLoader::loadAll(uint maxWorkers) {
+    timeutil::Timer timer;
+    while (!entries.empty()) {
+        std::vector<aloader_entry> batch;
+        batch.reserve(entries.size());
+        while (!entries.empty()) {
+            batch.push_back(std::move(entries.front()));
+            entries.pop();
+        }
+        // postfuncs may enqueue dependencies (model textures)
+        loadBatch(std::move(batch), maxWorkers);
+    }
+    int64_t totalTime = timer.stop();
+    for (const auto& [tag, typeStats] : stats) {
+        logger.info() << asset_type_name(tag) << ": " << typeStats.count
+                      << " loaded, decode " << typeStats.decodeTime / 1000
+                      << " ms, finalize " << typeStats.finalizeTime / 1000
+                      << " ms";
+    }
+    logger.info() << "assets loaded in " << totalTime / 1000 << " ms";
+}
+
+const std::map<AssetType, aloader_stats>& AssetsLoader::getStats() const {
+    return stats;
+}
+
 void addLayouts(
     const scriptenv& env,
     const std::string& prefix,
@@ -284,6 +490,14 @@ const ResPaths* AssetsLoader::getPaths() const {
     return paths;
 }
 
+void AssetsLoader::setCacheFolder(fs::path folder) {
+    cacheFolder = std::move(folder);
+}
+
+const fs::path& AssetsLoader::getCacheFolder() const {
+    return cacheFolder;
+}
+
 class LoaderWorker : public util::Worker<aloader_entry, assetload::postfunc> {
     AssetsLoader* loader;
 public:
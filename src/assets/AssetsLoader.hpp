@@ -5,8 +5,10 @@
 #include <map>
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "delegates.hpp"
 #include "interfaces/Task.hpp"
@@ -48,11 +50,27 @@ struct aloader_entry {
     std::shared_ptr<AssetCfg> config;
 };
 
+/// @brief Asset type loading time statistics
+struct aloader_stats {
+    uint count = 0;
+    /// @brief Total files decoding time (microseconds)
+    int64_t decodeTime = 0;
+    /// @brief Total main thread finalization time (microseconds)
+    int64_t finalizeTime = 0;
+};
+
 class AssetsLoader {
     Assets* assets;
     std::map<AssetType, aloader_func> loaders;
+    /// @brief Asset types which loaders may be called outside of
+    /// the main thread
+    std::set<AssetType> parallelLoaders;
+    std::map<AssetType, aloader_stats> stats;
     std::queue<aloader_entry> entries;
     const ResPaths* paths;
+    std::filesystem::path cacheFolder;
+
+    void loadBatch(std::vector<aloader_entry> batch, uint maxWorkers);
 
     void tryAddSound(const std::string& name);
 
@@ -64,7 +82,12 @@ class AssetsLoader {
     void processPreloadConfigs(const Content* content);
 public:
     AssetsLoader(Assets* assets, const ResPaths* paths);
-    void addLoader(AssetType tag, aloader_func func);
+
+    /// @param tag asset type
+    /// @param func asset loader
+    /// @param parallel loader is thread-safe and does not use GL
+    /// (main thread work must be done in the returned postfunc)
+    void addLoader(AssetType tag, aloader_func func, bool parallel = false);
 
     /// @brief Enqueue asset load
     /// @param tag asset type
@@ -83,9 +106,25 @@ public:
     /// @throws assetload::error
     void loadNext();
 
+    /// @brief Load all enqueued assets including ones enqueued by
+    /// postfuncs. Thread-safe loaders are called in the job system,
+    /// logging and postfuncs are performed in the calling thread in
+    /// the enqueue order, so the result does not depend on threads timing
+    /// @param maxWorkers max number of parallel decoding jobs (0 - auto)
+    /// @throws assetload::error on the first (in enqueue order) failed asset
+    void loadAll(uint maxWorkers = 0);
+
+    /// @brief Get loading time statistics by asset type
+    const std::map<AssetType, aloader_stats>& getStats() const;
+
     std::shared_ptr<Task> startTask(runnable onDone);
 
     const ResPaths* getPaths() const;
+
+    /// @brief Set folder for loaders cache files (empty path disables
+    /// caching)
+    void setCacheFolder(std::filesystem::path folder);
+    const std::filesystem::path& getCacheFolder() const;
     aloader_func getLoader(AssetType tag);
 
     /// @brief Enqueue core and content assets
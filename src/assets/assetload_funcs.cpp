@@ -1,9 +1,9 @@
 #include "assetload_funcs.hpp"
 
 #include <filesystem>
-#include <iostream>
 #include <stdexcept>
 
+#include "atlas_cache.hpp"
 #include "audio/audio.hpp"
 #include "coders/GLSLExtension.hpp"
 #include "coders/commons.hpp"
@@ -24,6 +24,7 @@
 #include "graphics/core/TextureAnimation.hpp"
 #include "graphics/commons/Model.hpp"
 #include "objects/rigging.hpp"
+#include "util/hash.hpp"
 #include "util/stringutil.hpp"
 #include "Assets.hpp"
 #include "AssetsLoader.hpp"
@@ -55,8 +56,9 @@ assetload::postfunc assetload::texture(
             assets->store(Texture::from(image.get()), name);
         };
     } catch (const std::runtime_error& err) {
-        logger.error() << actualFile << ": " << err.what();
-        return [](auto) {};
+        // decoder may run in a worker thread, so logged by the postfunc
+        std::string message = actualFile + ": " + err.what();
+        return [message](auto) { logger.error() << message; };
     }
 }
 
@@ -102,21 +104,92 @@ static bool append_atlas(AtlasBuilder& atlas, const fs::path& file) {
     return true;
 }
 
+static fs::path atlas_cache_file(
+    const fs::path& cacheFolder, const std::string& name
+) {
+    std::string filename = name;
+    for (char& c : filename) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-') {
+            c = '_';
+        }
+    }
+    return cacheFolder / fs::u8path("atlases/" + filename + ".bin");
+}
+
+/// @brief Hash of atlas input files and packing parameters. Files are
+/// identified by path, size and modification time, so the sources are not
+/// read on cache hit. Content is hashed if file status is not available
+static uint64_t atlas_sources_hash(
+    const std::vector<fs::path>& files, uint extrusion, uint maxResolution
+) {
+    util::Hasher64 hasher;
+    hasher.update(atlas_cache::VERSION);
+    hasher.update(extrusion);
+    hasher.update(maxResolution);
+    hasher.update(files.size());
+    for (const auto& file : files) {
+        hasher.update(file.u8string());
+        std::error_code ec;
+        auto size = fs::file_size(file, ec);
+        auto time = ec ? fs::file_time_type() : fs::last_write_time(file, ec);
+        if (ec) {
+            auto bytes = files::read_bytes(file);
+            hasher.update(bytes.size());
+            hasher.update(bytes.data(), bytes.size());
+            continue;
+        }
+        hasher.update(static_cast<uint64_t>(size));
+        hasher.update(static_cast<uint64_t>(time.time_since_epoch().count()));
+    }
+    return hasher.value();
+}
+
 assetload::postfunc assetload::atlas(
-    AssetsLoader*,
+    AssetsLoader* loader,
     const ResPaths* paths,
     const std::string& directory,
     const std::string& name,
     const std::shared_ptr<AssetCfg>&
 ) {
-    AtlasBuilder builder;
+    const uint extrusion = 2;
+    std::vector<fs::path> files;
     for (const auto& file : paths->listdir(directory)) {
         if (!imageio::is_read_supported(file.extension().u8string())) continue;
-        if (!append_atlas(builder, file)) continue;
+        files.push_back(file);
+    }
+    std::unique_ptr<Atlas> built;
+    fs::path cacheFile;
+    uint64_t key = 0;
+    if (!loader->getCacheFolder().empty()) {
+        cacheFile = atlas_cache_file(loader->getCacheFolder(), name);
+        key = atlas_sources_hash(files, extrusion, Texture::MAX_RESOLUTION);
+        built = atlas_cache::read(cacheFile, key);
     }
-    std::set<std::string> names = builder.getNames();
-    Atlas* atlas = builder.build(2, false).release();
+    std::string cacheError;
+    if (built == nullptr) {
+        AtlasBuilder builder;
+        for (const auto& file : files) {
+            if (!append_atlas(builder, file)) continue;
+        }
+        built = builder.build(extrusion, false);
+        if (!cacheFile.empty()) {
+            try {
+                atlas_cache::write(cacheFile, key, *built);
+            } catch (const std::exception& err) {
+                cacheError = err.what();
+            }
+        }
+    }
+    std::set<std::string> names;
+    for (const auto& [regionName, _] : built->getRegions()) {
+        names.insert(regionName);
+    }
+    Atlas* atlas = built.release();
     return [=](auto assets) {
+        if (!cacheError.empty()) {
+            logger.warning() << "could not to cache atlas " << name << ": "
+                             << cacheError;
+        }
         atlas->prepare();
         assets->store(std::unique_ptr<Atlas>(atlas), name);
         for (const auto& file : names) {
@@ -275,8 +348,10 @@ assetload::postfunc assetload::model(
             assets->store(std::unique_ptr<model::Model>(model), name);
         };
     } catch (const parsing_error& err) {
-        std::cerr << err.errorLog() << std::endl;
-        throw;
+        throw std::runtime_error(
+            "failed to parse model '" + path.u8string() + "':\n" +
+            err.errorLog()
+        );
     }
 }
 
@@ -0,0 +1,104 @@
+#include "atlas_cache.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "coders/byte_utils.hpp"
+#include "files/files.hpp"
+#include "graphics/core/Atlas.hpp"
+#include "graphics/core/ImageData.hpp"
+
+namespace fs = std::filesystem;
+
+static const char MAGIC[] = "VEATLAS";
+static constexpr size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+
+static size_t channels_count(ImageFormat format) {
+    switch (format) {
+        case ImageFormat::rgb888:
+            return 3;
+        case ImageFormat::rgba8888:
+            return 4;
+    }
+    throw std::runtime_error("unsupported image format");
+}
+
+std::unique_ptr<Atlas> atlas_cache::read(const fs::path& file, uint64_t key) {
+    if (!fs::is_regular_file(file)) {
+        return nullptr;
+    }
+    try {
+        auto bytes = files::read_bytes(file);
+        ByteReader reader(bytes.data(), bytes.size());
+        reader.checkMagic(MAGIC, MAGIC_SIZE);
+        if (reader.get() != VERSION ||
+            static_cast<uint64_t>(reader.getInt64()) != key) {
+            return nullptr;
+        }
+        auto format = static_cast<ImageFormat>(reader.get());
+        uint width = reader.getInt32();
+        uint height = reader.getInt32();
+        size_t count = static_cast<uint32_t>(reader.getInt32());
+
+        std::unordered_map<std::string, UVRegion> regions;
+        regions.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            auto name = reader.getString();
+            float u1 = reader.getFloat32();
+            float v1 = reader.getFloat32();
+            float u2 = reader.getFloat32();
+            float v2 = reader.getFloat32();
+            regions[name] = UVRegion(u1, v1, u2, v2);
+        }
+        size_t size = static_cast<size_t>(width) * height *
+                      channels_count(format);
+        if (reader.remaining() != size) {
+            return nullptr;
+        }
+        auto data = std::make_unique<ubyte[]>(size);
+        std::memcpy(data.get(), reader.pointer(), size);
+        auto image = std::make_unique<ImageData>(
+            format, width, height, std::move(data)
+        );
+        return std::make_unique<Atlas>(
+            std::move(image), std::move(regions), false
+        );
+    } catch (const std::runtime_error&) {
+        return nullptr;
+    }
+}
+
+void atlas_cache::write(
+    const fs::path& file, uint64_t key, const Atlas& atlas
+) {
+    const auto& image = *atlas.getImage();
+    const auto& regions = atlas.getRegions();
+    size_t size = static_cast<size_t>(image.getWidth()) * image.getHeight() *
+                  channels_count(image.getFormat());
+
+    ByteBuilder builder;
+    builder.reserve(size + regions.size() * 40 + 64);
+    builder.put(reinterpret_cast<const ubyte*>(MAGIC), MAGIC_SIZE);
+    builder.put(VERSION);
+    builder.putInt64(key);
+    builder.put(static_cast<ubyte>(image.getFormat()));
+    builder.putInt32(image.getWidth());
+    builder.putInt32(image.getHeight());
+    builder.putInt32(regions.size());
+    for (const auto& [name, region] : regions) {
+        builder.put(name);
+        builder.putFloat32(region.u1);
+        builder.putFloat32(region.v1);
+        builder.putFloat32(region.u2);
+        builder.putFloat32(region.v2);
+    }
+    builder.put(image.getData(), size);
+
+    fs::create_directories(file.parent_path());
+    auto tmpFile = file;
+    tmpFile += ".tmp";
+    if (!files::write_bytes(tmpFile, builder.data(), builder.size())) {
+        throw std::runtime_error("could not write " + tmpFile.u8string());
+    }
+    fs::rename(tmpFile, file);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+#include "typedefs.hpp"
+
+class Atlas;
+
+/// @brief Packed atlases cache. Each file stores atlas raster and regions
+/// table with the hash of sources (input files and packing parameters),
+/// so unchanged atlas is loaded with a single file read instead of
+/// decoding and packing all images
+namespace atlas_cache {
+    inline constexpr ubyte VERSION = 1;
+
+    /// @brief Read cached atlas (not prepared)
+    /// @param file cache file
+    /// @param key sources hash
+    /// @return nullptr if file does not exist, is invalid or outdated
+    std::unique_ptr<Atlas> read(const std::filesystem::path& file, uint64_t key);
+
+    /// @brief Write atlas to the cache file. Write is atomic: file is
+    /// replaced with a temporary one after it's fully written
+    /// @throws std::runtime_error - write failed
+    void write(
+        const std::filesystem::path& file, uint64_t key, const Atlas& atlas
+    );
+}
@@ -9,19 +9,22 @@
 
 using namespace json;
 
-static void to_binary(ByteBuilder& builder, const dv::value& value) {
+/// @brief Max size of the thread scratch buffer kept between calls
+static constexpr size_t MAX_SCRATCH_SIZE = 4 * 1024 * 1024;
+
+static void write_document(ByteBuilder& builder, const dv::value& object);
+
+static void write_value(ByteBuilder& builder, const dv::value& value) {
     switch (value.getType()) {
         case dv::value_type::none:
             throw std::runtime_error("none value is not implemented");
-        case dv::value_type::object: {
-            const auto bytes = json::to_binary(value);
-            builder.put(bytes.data(), bytes.size());
+        case dv::value_type::object:
+            write_document(builder, value);
             break;
-        }
         case dv::value_type::list:
             builder.put(BJSON_TYPE_LIST);
             for (const auto& element : value) {
-                to_binary(builder, element);
+                write_value(builder, element);
             }
             builder.put(BJSON_END);
             break;
@@ -63,27 +66,44 @@ static void to_binary(ByteBuilder& builder, const dv::value& value) {
     }
 }
 
-std::vector<ubyte> json::to_binary(const dv::value& object, bool compress) {
-    if (compress) {
-        auto bytes = to_binary(object, false);
-        return gzip::compress(bytes.data(), bytes.size());
-    }
-    ByteBuilder builder;
+static void write_document(ByteBuilder& builder, const dv::value& object) {
+    size_t start = builder.size();
     // type byte
     builder.put(BJSON_TYPE_DOCUMENT);
-    // document size
+    // document size, updated when entries are written
     builder.putInt32(0);
 
     // writing entries
     for (const auto& [key, value] : object.asObject()) {
         builder.putCStr(key.c_str());
-        to_binary(builder, value);
+        write_value(builder, value);
     }
     // terminating byte
     builder.put(BJSON_END);
 
     // updating document size
-    builder.setInt32(1, builder.size());
+    builder.setInt32(start + 1, builder.size() - start);
+}
+
+void json::to_binary(
+    ByteBuilder& builder, const dv::value& object, bool compress
+) {
+    if (!compress) {
+        write_document(builder, object);
+        return;
+    }
+    thread_local ByteBuilder scratch;
+    scratch.clear();
+    write_document(scratch, object);
+    gzip::compress(scratch.data(), scratch.size(), builder);
+    if (scratch.size() > MAX_SCRATCH_SIZE) {
+        scratch = ByteBuilder();
+    }
+}
+
+std::vector<ubyte> json::to_binary(const dv::value& object, bool compress) {
+    ByteBuilder builder;
+    to_binary(builder, object, compress);
     return builder.build();
 }
 
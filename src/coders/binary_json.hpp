@@ -7,6 +7,8 @@
 
 #include "typedefs.hpp"
 
+class ByteBuilder;
+
 namespace json {
     inline constexpr int BJSON_END = 0x0;
     inline constexpr int BJSON_TYPE_DOCUMENT = 0x1;
@@ -24,6 +26,12 @@ namespace json {
     inline constexpr int BJSON_TYPE_CDOCUMENT = 0x1F;
 
     std::vector<ubyte> to_binary(const dv::value& obj, bool compress = false);
+
+    /// @brief Write document to the end of the builder in a single pass.
+    /// Nested documents sizes are written in place
+    void to_binary(
+        ByteBuilder& builder, const dv::value& obj, bool compress = false
+    );
     
     dv::value from_binary(const ubyte* src, size_t size);
 }
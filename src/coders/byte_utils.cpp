@@ -11,11 +11,7 @@ void ByteBuilder::put(ubyte b) {
 }
 
 void ByteBuilder::putCStr(const char* str) {
-    size_t size = std::strlen(str) + 1;
-    buffer.reserve(buffer.size() + size);
-    for (size_t i = 0; i < size; i++) {
-        buffer.push_back(str[i]);
-    }
+    put(reinterpret_cast<const ubyte*>(str), std::strlen(str) + 1);
 }
 
 void ByteBuilder::put(const std::string& s) {
@@ -25,10 +21,8 @@ void ByteBuilder::put(const std::string& s) {
 }
 
 void ByteBuilder::put(const ubyte* arr, size_t size) {
-    buffer.reserve(buffer.size() + size);
-    for (size_t i = 0; i < size; i++) {
-        buffer.push_back(arr[i]);
-    }
+    // insert keeps geometric growth unlike exact reserve
+    buffer.insert(buffer.end(), arr, arr + size);
 }
 
 void ByteBuilder::putInt16(int16_t val) {
@@ -84,7 +78,9 @@ void ByteBuilder::setInt64(size_t position, int64_t val) {
 }
 
 std::vector<ubyte> ByteBuilder::build() {
-    return buffer;
+    auto bytes = std::move(buffer);
+    buffer.clear();
+    return bytes;
 }
 
 ByteReader::ByteReader(const ubyte* data, size_t size)
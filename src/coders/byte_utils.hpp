@@ -8,6 +8,12 @@
 class ByteBuilder {
     std::vector<ubyte> buffer;
 public:
+    ByteBuilder() = default;
+    /// @brief Append to the end of the given buffer
+    explicit ByteBuilder(std::vector<ubyte> buffer)
+        : buffer(std::move(buffer)) {
+    }
+
     /// @brief Write one byte (8 bit unsigned integer)
     void put(ubyte b);
     /// @brief Write c-string (bytes array terminated with '\00')
@@ -40,6 +46,16 @@ public:
         return buffer.data();
     }
 
+    void reserve(size_t size) {
+        buffer.reserve(size);
+    }
+
+    /// @brief Remove all written bytes keeping allocated memory
+    void clear() {
+        buffer.clear();
+    }
+
+    /// @brief Move written bytes out of the builder. Builder is empty after
     std::vector<ubyte> build();
 };
 
@@ -7,37 +7,78 @@
 #include <zlib.h>
 
 #include <memory>
+#include <stdexcept>
 
-std::vector<ubyte> gzip::compress(const ubyte* src, size_t size) {
-    size_t buffer_size = 23 + size * 1.01;
-    std::vector<ubyte> buffer;
-    buffer.resize(buffer_size);
+/// @brief Size of output chunks passed to the destination
+static constexpr size_t OUTPUT_CHUNK_SIZE = 16 * 1024;
 
-    // zlib struct
-    z_stream defstream {};
-    defstream.zalloc = Z_NULL;
-    defstream.zfree = Z_NULL;
-    defstream.opaque = Z_NULL;
-    defstream.avail_in = size;
-    defstream.next_in = src;
-    defstream.avail_out = buffer_size;
-    defstream.next_out = buffer.data();
-
-    // compression
-    deflateInit2(
-        &defstream,
+struct gzip::Compressor::Stream {
+    z_stream zstream {};
+    bool finished = false;
+};
+
+gzip::Compressor::Compressor(ByteBuilder& dst)
+    : stream(std::make_unique<Stream>()), dst(dst) {
+    int result = deflateInit2(
+        &stream->zstream,
         Z_DEFAULT_COMPRESSION,
         Z_DEFLATED,
         16 + MAX_WBITS,
         8,
         Z_DEFAULT_STRATEGY
     );
-    deflate(&defstream, Z_FINISH);
-    deflateEnd(&defstream);
+    if (result != Z_OK) {
+        throw std::runtime_error("could not initialize gzip compressor");
+    }
+}
 
-    size_t compressed_size = defstream.next_out - buffer.data();
-    buffer.resize(compressed_size);
-    return buffer;
+gzip::Compressor::~Compressor() {
+    deflateEnd(&stream->zstream);
+}
+
+void gzip::Compressor::deflate(int flush) {
+    auto& zstream = stream->zstream;
+    ubyte chunk[OUTPUT_CHUNK_SIZE];
+    do {
+        zstream.avail_out = OUTPUT_CHUNK_SIZE;
+        zstream.next_out = chunk;
+        int result = ::deflate(&zstream, flush);
+        if (result == Z_STREAM_ERROR) {
+            throw std::runtime_error("gzip compression error");
+        }
+        dst.put(chunk, OUTPUT_CHUNK_SIZE - zstream.avail_out);
+    } while (zstream.avail_out == 0);
+}
+
+void gzip::Compressor::write(const ubyte* src, size_t size) {
+    if (stream->finished) {
+        throw std::runtime_error("gzip compressor is finished");
+    }
+    auto& zstream = stream->zstream;
+    zstream.next_in = src;
+    zstream.avail_in = size;
+    deflate(Z_NO_FLUSH);
+}
+
+void gzip::Compressor::finish() {
+    if (stream->finished) {
+        return;
+    }
+    stream->zstream.avail_in = 0;
+    deflate(Z_FINISH);
+    stream->finished = true;
+}
+
+void gzip::compress(const ubyte* src, size_t size, ByteBuilder& dst) {
+    Compressor compressor(dst);
+    compressor.write(src, size);
+    compressor.finish();
+}
+
+std::vector<ubyte> gzip::compress(const ubyte* src, size_t size) {
+    ByteBuilder builder;
+    compress(src, size, builder);
+    return builder.build();
 }
 
 std::vector<ubyte> gzip::decompress(const ubyte* src, size_t size) {
@@ -1,17 +1,46 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "typedefs.hpp"
 
+class ByteBuilder;
+
 namespace gzip {
     const unsigned char MAGIC[] = "\x1F\x8B";
 
+    /// @brief Streaming GZIP compressor writing compressed data to the end
+    /// of the destination builder as input arrives
+    class Compressor {
+        struct Stream;
+        std::unique_ptr<Stream> stream;
+        ByteBuilder& dst;
+
+        void deflate(int flush);
+    public:
+        Compressor(ByteBuilder& dst);
+        ~Compressor();
+
+        /// @brief Compress next input bytes
+        void write(const ubyte* src, size_t size);
+
+        /// @brief Flush remaining data and write GZIP footer.
+        /// Further writes are not allowed
+        void finish();
+    };
+
     /* Compress bytes array to GZIP format
      @param src source bytes array
      @param size length of source bytes array */
     std::vector<ubyte> compress(const ubyte* src, size_t size);
 
+    /* Compress bytes array to GZIP format appending to the builder
+     @param src source bytes array
+     @param size length of source bytes array
+     @param dst destination builder */
+    void compress(const ubyte* src, size_t size, ByteBuilder& dst);
+
     /* Decompress bytes array from GZIP
      @param src GZIP data
      @param size length of GZIP data */
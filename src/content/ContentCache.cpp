@@ -0,0 +1,78 @@
+#include "ContentCache.hpp"
+
+#include "coders/binary_json.hpp"
+#include "debug/Logger.hpp"
+#include "files/files.hpp"
+
+static debug::Logger logger("content-cache");
+
+ContentCache::ContentCache(fs::path file) : file(std::move(file)) {
+    if (!fs::is_regular_file(this->file)) {
+        return;
+    }
+    try {
+        auto root = files::read_binary_json(this->file);
+        if (root["version"].asInteger() != VERSION) {
+            return;
+        }
+        for (const auto& [path, map] : root["files"].asObject()) {
+            entries[path] = Entry {
+                map["mtime"].asInteger(),
+                map["size"].asInteger(),
+                map["data"]};
+        }
+    } catch (const std::runtime_error& err) {
+        logger.warning() << "invalid cache " << this->file.u8string() << ": "
+                         << err.what();
+        entries.clear();
+    }
+}
+
+dv::value ContentCache::read(const fs::path& file) {
+    auto key = file.u8string();
+    int64_t mtime = fs::last_write_time(file).time_since_epoch().count();
+    int64_t size = fs::file_size(file);
+    used.insert(key);
+
+    const auto& found = entries.find(key);
+    if (found != entries.end() && found->second.mtime == mtime &&
+        found->second.size == size) {
+        hits++;
+        return found->second.data;
+    }
+    misses++;
+    auto data = files::read_object(file);
+    entries[key] = Entry {mtime, size, data};
+    modified = true;
+    return data;
+}
+
+void ContentCache::save() {
+    if (file.empty() || (!modified && used.size() == entries.size())) {
+        return;
+    }
+    auto root = dv::object();
+    root["version"] = VERSION;
+    auto& filesMap = root.object("files");
+    for (const auto& [path, entry] : entries) {
+        if (used.find(path) == used.end()) {
+            continue;
+        }
+        auto& map = filesMap.object(path);
+        map["mtime"] = entry.mtime;
+        map["size"] = entry.size;
+        map["data"] = entry.data;
+    }
+    try {
+        fs::create_directories(file.parent_path());
+        auto tmpFile = file;
+        tmpFile += ".tmp";
+        if (!files::write_binary_json(tmpFile, root, true)) {
+            throw std::runtime_error("could not write " + tmpFile.u8string());
+        }
+        fs::rename(tmpFile, file);
+        modified = false;
+    } catch (const std::runtime_error& err) {
+        logger.warning() << "could not save content cache: " << err.what();
+    }
+}
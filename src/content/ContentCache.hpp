@@ -0,0 +1,55 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "data/dv.hpp"
+
+namespace fs = std::filesystem;
+
+/// @brief Cache of parsed content definition files (json, toml).
+///
+/// Whole cache is a single binary json file loaded with one read.
+/// An entry is valid while the source file size and modification time
+/// are unchanged. Entries not requested since load are dropped on save.
+class ContentCache {
+    struct Entry {
+        int64_t mtime;
+        int64_t size;
+        dv::value data;
+    };
+    fs::path file;
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_set<std::string> used;
+    size_t hits = 0;
+    size_t misses = 0;
+    bool modified = false;
+public:
+    static constexpr int VERSION = 1;
+
+    /// @brief Create in-memory only cache
+    ContentCache() = default;
+
+    /// @brief Load cache file. Missing, invalid or outdated (other version)
+    /// file is ignored
+    /// @param file cache file path
+    explicit ContentCache(fs::path file);
+
+    /// @brief Read definition file of supported format using the cache.
+    /// Returned value is shared with the cache and must not be modified
+    /// @throws std::runtime_error - file read or parsing failed
+    dv::value read(const fs::path& file);
+
+    /// @brief Write cache file if changed
+    void save();
+
+    size_t getHits() const {
+        return hits;
+    }
+
+    size_t getMisses() const {
+        return misses;
+    }
+};
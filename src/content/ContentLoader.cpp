@@ -8,6 +8,7 @@
 
 #include "Content.hpp"
 #include "ContentBuilder.hpp"
+#include "ContentCache.hpp"
 #include "ContentPack.hpp"
 #include "coders/json.hpp"
 #include "core_defs.hpp"
@@ -30,9 +31,12 @@ using namespace data;
 static debug::Logger logger("content-loader");
 
 ContentLoader::ContentLoader(
-    ContentPack* pack, ContentBuilder& builder, const ResPaths& paths
+    ContentPack* pack,
+    ContentBuilder& builder,
+    const ResPaths& paths,
+    ContentCache* cache
 )
-    : pack(pack), builder(builder), paths(paths) {
+    : pack(pack), builder(builder), paths(paths), cache(cache) {
     auto runtime = std::make_unique<ContentPackRuntime>(
         *pack, scripting::create_pack_environment(*pack)
     );
@@ -42,10 +46,18 @@ ContentLoader::ContentLoader(
     builder.add(std::move(runtime));
 }
 
+dv::value ContentLoader::readFile(const fs::path& file) {
+    if (cache) {
+        return cache->read(file);
+    }
+    return files::read_object(file);
+}
+
 static void detect_defs(
     const fs::path& folder,
     const std::string& prefix,
-    std::vector<std::string>& detected
+    std::vector<std::string>& detected,
+    ContentCache* cache
 ) {
     if (fs::is_directory(folder)) {
         for (const auto& entry : fs::directory_iterator(folder)) {
@@ -55,12 +67,13 @@ static void detect_defs(
                 continue;
             }
             if (fs::is_regular_file(file) && files::is_data_file(file)) {
-                auto map = files::read_object(file);
+                // validate the file
+                auto map = cache ? cache->read(file) : files::read_object(file);
                 std::string id = prefix.empty() ? name : prefix + ":" + name;
                 detected.emplace_back(id);
             } else if (fs::is_directory(file) && 
                        file.extension() != fs::u8path(".files")) {
-                detect_defs(file, name, detected);
+                detect_defs(file, name, detected, cache);
             }
         }
     }
@@ -108,10 +121,11 @@ std::vector<std::tuple<std::string, std::string>> ContentLoader::scanContent(
 bool ContentLoader::fixPackIndices(
     const fs::path& folder,
     dv::value& indicesRoot,
-    const std::string& contentSection
+    const std::string& contentSection,
+    ContentCache* cache
 ) {
     std::vector<std::string> detected;
-    detect_defs(folder, "", detected);
+    detect_defs(folder, "", detected, cache);
 
     std::vector<std::string> indexed;
     bool modified = false;
@@ -153,9 +167,9 @@ void ContentLoader::fixPackIndices() {
     }
 
     bool modified = false;
-    modified |= fixPackIndices(blocksFolder, root, "blocks");
-    modified |= fixPackIndices(itemsFolder, root, "items");
-    modified |= fixPackIndices(entitiesFolder, root, "entities");
+    modified |= fixPackIndices(blocksFolder, root, "blocks", cache);
+    modified |= fixPackIndices(itemsFolder, root, "items", cache);
+    modified |= fixPackIndices(entitiesFolder, root, "entities", cache);
 
     if (modified) {
         // rewrite modified json
@@ -190,7 +204,7 @@ static void perform_user_block_fields(
 void ContentLoader::loadBlock(
     Block& def, const std::string& name, const fs::path& file
 ) {
-    auto root = files::read_json(file);
+    auto root = readFile(file);
 
     if (root.has("parent")) {
         const auto& parentName = root["parent"].asString();
@@ -358,7 +372,7 @@ void ContentLoader::loadBlock(
 void ContentLoader::loadItem(
     ItemDef& def, const std::string& name, const fs::path& file
 ) {
-    auto root = files::read_json(file);
+    auto root = readFile(file);
 
     if (root.has("parent")) {
         const auto& parentName = root["parent"].asString();
@@ -401,7 +415,7 @@ void ContentLoader::loadItem(
 void ContentLoader::loadEntity(
     EntityDef& def, const std::string& name, const fs::path& file
 ) {
-    auto root = files::read_json(file);
+    auto root = readFile(file);
 
     if (root.has("parent")) {
         const auto& parentName = root["parent"].asString();
@@ -529,7 +543,7 @@ static std::tuple<std::string, std::string, std::string> create_unit_id(
 void ContentLoader::loadBlockMaterial(
     BlockMaterial& def, const fs::path& file
 ) {
-    auto root = files::read_json(file);
+    auto root = readFile(file);
     root.at("steps-sound").get(def.stepsSound);
     root.at("place-sound").get(def.placeSound);
     root.at("break-sound").get(def.breakSound);
@@ -541,7 +555,7 @@ void ContentLoader::loadContent(const dv::value& root) {
             auto configFile = pack->folder / fs::path(prefix + "/" + name + ".json");
             std::string parent;
             if (fs::exists(configFile)) {
-                auto root = files::read_json(configFile);
+                auto root = readFile(configFile);
                 root.at("parent").get(parent);
             }
             return parent;
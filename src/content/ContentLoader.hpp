@@ -18,6 +18,7 @@ struct GeneratorDef;
 
 class ResPaths;
 class ContentBuilder;
+class ContentCache;
 class ContentPackRuntime;
 struct ContentPackStats;
 
@@ -28,6 +29,10 @@ class ContentLoader {
     ContentBuilder& builder;
     ContentPackStats* stats;
     const ResPaths& paths;
+    ContentCache* cache;
+
+    /// @brief Read definition file using the cache if available
+    dv::value readFile(const fs::path& file);
 
     void loadBlock(
         Block& def, const std::string& full, const std::string& name
@@ -42,7 +47,7 @@ class ContentLoader {
         GeneratorDef& def, const std::string& full, const std::string& name
     );
 
-    static void loadBlockMaterial(BlockMaterial& def, const fs::path& file);
+    void loadBlockMaterial(BlockMaterial& def, const fs::path& file);
     void loadBlock(
         Block& def, const std::string& name, const fs::path& file
     );
@@ -57,17 +62,20 @@ class ContentLoader {
 
     void loadContent(const dv::value& map);
 public:
+    /// @param cache parsed definition files cache (optional)
     ContentLoader(
         ContentPack* pack,
         ContentBuilder& builder,
-        const ResPaths& paths
+        const ResPaths& paths,
+        ContentCache* cache = nullptr
     );
 
     // Refresh pack content.json
     static bool fixPackIndices(
         const fs::path& folder,
         dv::value& indicesRoot,
-        const std::string& contentSection
+        const std::string& contentSection,
+        ContentCache* cache = nullptr
     );
 
     static std::vector<std::tuple<std::string, std::string>> scanContent(
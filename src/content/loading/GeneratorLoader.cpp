@@ -11,6 +11,7 @@
 #include "world/generator/VoxelFragment.hpp"
 #include "debug/Logger.hpp"
 #include "util/stringutil.hpp"
+#include "util/hash.hpp"
 
 static BlocksLayer load_layer(
     const dv::value& map, uint& lastLayersHeight, bool& hasResizeableLayer
@@ -197,7 +198,7 @@ void ContentLoader::loadGenerator(
     if (!fs::exists(generatorFile)) {
         return;
     }
-    auto map = files::read_toml(generatorsDir / fs::u8path(name + ".toml"));
+    auto map = readFile(generatorFile);
     map.at("caption").get(def.caption);
     map.at("biome-parameters").get(def.biomeParameters);
     map.at("biome-bpd").get(def.biomesBPD);
@@ -245,6 +246,11 @@ void ContentLoader::loadGenerator(
         );
     }
     load_biomes(def, biomesMap);
+    if (fs::is_regular_file(scriptFile)) {
+        util::Hasher64 hasher;
+        hasher.update(files::read_string(scriptFile));
+        def.scriptHash = hasher.value();
+    }
     def.script = scripting::load_generator(
         def, scriptFile, pack->id+":generators/"+name+".files");
 }
@@ -142,6 +142,35 @@ namespace data {
             return &fields.at(found->second);
         }
 
+        /// @brief Get index of the field in layout. Unlike field name, index
+        /// may be stored and used to access field without string hashing.
+        /// @param name field name
+        /// @return field index or -1 if field not found
+        [[nodiscard]]
+        int getFieldIndex(const std::string& name) const {
+            auto found = indices.find(name);
+            if (found == indices.end()) {
+                return -1;
+            }
+            return found->second;
+        }
+
+        /// @brief Get field by index. Returns nullptr if index is out of range.
+        /// @param index field index
+        /// @return nullable field pointer
+        [[nodiscard]]
+        const Field* getFieldAt(size_t index) const {
+            if (index >= fields.size()) {
+                return nullptr;
+            }
+            return &fields[index];
+        }
+
+        /// @return number of fields
+        [[nodiscard]] size_t countFields() const {
+            return fields.size();
+        }
+
         /// @brief Get field by name
         /// @throws std::runtime_exception - field not found
         /// @param name field name
@@ -9,6 +9,8 @@
 #include <stdexcept>
 #include <unordered_map>
 
+#include "dv_arena.hpp"
+
 namespace util {
     template<class T> class Buffer;
 }
@@ -47,19 +49,25 @@ namespace dv {
 
     class value;
 
-    using list_t = std::vector<value>;
-    using map_t = std::unordered_map<key_t, value>;
     using pair = std::pair<const key_t, value>;
 
     using reference = value&;
     using const_reference = const value&;
 
     namespace objects {
-        using Object = std::unordered_map<key_t, value>;
-        using List = std::vector<value>;
+        using Object = std::unordered_map<
+            key_t,
+            value,
+            std::hash<key_t>,
+            std::equal_to<key_t>,
+            allocator<pair>>;
+        using List = std::vector<value, allocator<value>>;
         using Bytes = util::Buffer<byte_t>;
     }
 
+    using list_t = objects::List;
+    using map_t = objects::Object;
+
     /// @brief nullable value reference returned by value.at(...)
     struct optionalvalue {
         value* ptr;
@@ -197,7 +205,9 @@ namespace dv {
             this->operator=(std::move(v));
         }
         value(list_t values) {
-            this->operator=(std::make_shared<list_t>(std::move(values)));
+            this->operator=(std::allocate_shared<list_t>(
+                allocator<list_t>(), std::move(values)
+            ));
         }
 
         value(const value& v) noexcept : type(value_type::none) {
@@ -521,19 +531,25 @@ namespace dv {
     }
 
     inline value object() {
-        return std::make_shared<objects::Object>();
+        return std::allocate_shared<objects::Object>(
+            allocator<objects::Object>()
+        );
     }
 
     inline value object(std::initializer_list<pair> pairs) {
-        return std::make_shared<objects::Object>(std::move(pairs));
+        return std::allocate_shared<objects::Object>(
+            allocator<objects::Object>(), std::move(pairs)
+        );
     }
 
     inline value list() {
-        return std::make_shared<objects::List>();
+        return std::allocate_shared<objects::List>(allocator<objects::List>());
     }
 
     inline value list(std::initializer_list<value> values) {
-        return std::make_shared<objects::List>(std::move(values));
+        return std::allocate_shared<objects::List>(
+            allocator<objects::List>(), std::move(values)
+        );
     }
 
     template<typename T> inline bool get_to_int(value* ptr, T& dst) {
@@ -0,0 +1,96 @@
+#include "dv_arena.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+using namespace dv;
+
+namespace {
+    struct alignas(std::max_align_t) Block {
+        /// @brief Number of live allocations + 1 while the block is
+        /// used by a scope
+        std::atomic<size_t> refs;
+        size_t size;
+        size_t used = 0;
+
+        Block(size_t size) : refs(1), size(size) {
+        }
+
+        uint8_t* data() {
+            return reinterpret_cast<uint8_t*>(this + 1);
+        }
+    };
+
+    /// @brief Placed before each allocation. Block is nullptr for
+    /// heap allocations
+    struct alignas(std::max_align_t) Header {
+        Block* block;
+    };
+
+    thread_local ArenaScope* current = nullptr;
+}
+
+static constexpr size_t align_size(size_t size) {
+    constexpr size_t align = alignof(std::max_align_t);
+    return (size + align - 1) / align * align;
+}
+
+static Block* create_block(size_t size) {
+    return new (::operator new(sizeof(Block) + size)) Block(size);
+}
+
+static void release_block(Block* block) noexcept {
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        block->~Block();
+        ::operator delete(block);
+    }
+}
+
+void* arena::allocate(size_t size) {
+    size_t total = align_size(sizeof(Header) + size);
+    ArenaScope* scope = current;
+    if (scope == nullptr || total > scope->blockSize / 4) {
+        auto header = static_cast<Header*>(::operator new(total));
+        header->block = nullptr;
+        return header + 1;
+    }
+    auto block = static_cast<Block*>(scope->block);
+    if (block == nullptr || block->used + total > block->size) {
+        // scope keeps the old block if allocation fails
+        auto newBlock = create_block(scope->blockSize);
+        if (block) {
+            release_block(block);
+        }
+        block = newBlock;
+        scope->block = block;
+    }
+    auto header = reinterpret_cast<Header*>(block->data() + block->used);
+    header->block = block;
+    block->used += total;
+    block->refs.fetch_add(1, std::memory_order_relaxed);
+    return header + 1;
+}
+
+void arena::deallocate(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto header = static_cast<Header*>(ptr) - 1;
+    if (header->block == nullptr) {
+        ::operator delete(header);
+    } else {
+        release_block(header->block);
+    }
+}
+
+ArenaScope::ArenaScope(size_t blockSize)
+    : previous(current), blockSize(align_size(blockSize)) {
+    current = this;
+}
+
+ArenaScope::~ArenaScope() {
+    if (block) {
+        release_block(static_cast<Block*>(block));
+    }
+    current = previous;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace dv {
+    /// @brief Allocation memory for dv objects and lists.
+    ///
+    /// While an ArenaScope is alive, allocations made by the thread are
+    /// placed in large arena blocks by bumping a pointer. A block is freed
+    /// at once when all allocations placed in it are deallocated, so a
+    /// dropped document releases its memory in a few free calls. Values
+    /// may outlive the scope and may be freed by any thread.
+    ///
+    /// Without scope (and for large allocations) memory is taken from heap.
+    /// Any value kept alive pins its whole block, so scopes are used only
+    /// for documents dropped soon after decoding.
+    namespace arena {
+        /// @brief Default arena block size
+        inline constexpr size_t BLOCK_SIZE = 32 * 1024;
+
+        void* allocate(size_t size);
+
+        void deallocate(void* ptr) noexcept;
+    }
+
+    /// @brief Makes dv objects and lists created by the current thread
+    /// arena-allocated until the scope is destroyed.
+    /// Scopes may be nested
+    class ArenaScope {
+        ArenaScope* previous;
+        void* block = nullptr;
+        size_t blockSize;
+
+        friend void* arena::allocate(size_t size);
+    public:
+        ArenaScope(size_t blockSize=arena::BLOCK_SIZE);
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+    };
+
+    /// @brief Stateless allocator used by dv containers
+    template<class T>
+    struct allocator {
+        using value_type = T;
+
+        allocator() noexcept = default;
+
+        template<class U>
+        allocator(const allocator<U>&) noexcept {}
+
+        T* allocate(size_t n) {
+            static_assert(
+                alignof(T) <= alignof(std::max_align_t),
+                "over-aligned types are not supported"
+            );
+            return static_cast<T*>(arena::allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, size_t) noexcept {
+            arena::deallocate(ptr);
+        }
+
+        template<class U>
+        bool operator==(const allocator<U>&) const noexcept {
+            return true;
+        }
+
+        template<class U>
+        bool operator!=(const allocator<U>&) const noexcept {
+            return false;
+        }
+    };
+}
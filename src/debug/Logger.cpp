@@ -1,36 +1,42 @@
 #include "Logger.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <utility>
 
+#include "util/RingQueue.hpp"
+
 using namespace debug;
+using std::chrono::system_clock;
 
-std::ofstream Logger::file;
-std::mutex Logger::mutex;
-std::string Logger::utcOffset = "";
-unsigned Logger::moduleLen = 20;
+static std::ofstream file;
+/// @brief Guards output in synchronous mode
+static std::mutex mutex;
+static std::string utc_offset = "";
+static unsigned module_len = 20;
 
-LogMessage::~LogMessage() {
-    logger->log(level, ss.str());
+namespace {
+    struct LogRecord {
+        LogLevel level;
+        system_clock::time_point time;
+        std::string name;
+        std::string message;
+    };
 }
 
-Logger::Logger(std::string name) : name(std::move(name)) {
-}
-
-void Logger::log(
-    LogLevel level, const std::string& name, const std::string& message
-) {
+static std::string format_record(const LogRecord& record) {
     using namespace std::chrono;
 
     std::stringstream ss;
-    switch (level) {
+    switch (record.level) {
         case LogLevel::debug:
-#ifdef NDEBUG
-            return;
-#endif
             ss << "[D]";
             break;
         case LogLevel::info:
@@ -43,40 +49,198 @@ void Logger::log(
             ss << "[E]";
             break;
     }
-    time_t tm = std::time(nullptr);
+    time_t tm = system_clock::to_time_t(record.time);
     auto ms =
-        duration_cast<milliseconds>(system_clock::now().time_since_epoch()) %
-        1000;
+        duration_cast<milliseconds>(record.time.time_since_epoch()) % 1000;
     ss << " " << std::put_time(std::localtime(&tm), "%Y/%m/%d %T");
     ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    ss << utcOffset << " [" << std::setfill(' ') << std::setw(moduleLen) << name
-       << "] ";
-    ss << message;
-    {
-        std::lock_guard<std::mutex> lock(mutex);
-        auto string = ss.str();
-        if (file.good()) {
-            file << string << '\n';
+    ss << utc_offset << " [" << std::setfill(' ') << std::setw(module_len)
+       << record.name << "] ";
+    ss << record.message;
+    return ss.str();
+}
+
+static void write_line(const std::string& string, bool flush) {
+    if (file.good()) {
+        file << string << '\n';
+        if (flush) {
             file.flush();
         }
-        std::cout << string << std::endl;
+    }
+    std::cout << string << '\n';
+    if (flush) {
+        std::cout.flush();
     }
 }
 
-void Logger::init(const std::string& filename) {
+namespace {
+    /// @brief Background records writer used in async mode
+    class AsyncWriter {
+        static constexpr size_t QUEUE_CAPACITY = 4096;
+
+        util::RingQueue<LogRecord> queue {QUEUE_CAPACITY};
+        std::atomic<size_t> flushRequests = 0;
+        std::atomic<size_t> flushesDone = 0;
+        std::atomic<size_t> dropped = 0;
+        std::atomic<bool> running = true;
+        std::mutex mutex;
+        std::condition_variable variable;
+        std::thread thread;
+
+        void writerLoop() {
+            LogRecord record;
+            size_t reportedDrops = 0;
+            while (true) {
+                // records pushed before the request are popped below
+                size_t requests = flushRequests;
+                bool any = false;
+                while (queue.pop(record)) {
+                    write_line(format_record(record), false);
+                    any = true;
+                }
+                size_t drops = dropped;
+                if (drops != reportedDrops) {
+                    write_line(
+                        format_record(LogRecord {
+                            LogLevel::warning,
+                            system_clock::now(),
+                            "logger",
+                            std::to_string(drops - reportedDrops) +
+                                " messages dropped (queue overflow)"}),
+                        false
+                    );
+                    reportedDrops = drops;
+                    any = true;
+                }
+                if (any || requests != flushesDone) {
+                    // batch is written, flush once
+                    file.flush();
+                    std::cout.flush();
+                    flushesDone = requests;
+                    continue;
+                }
+                if (!running) {
+                    break;
+                }
+                std::unique_lock<std::mutex> lock(mutex);
+                variable.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+    public:
+        AsyncWriter() : thread(&AsyncWriter::writerLoop, this) {
+        }
+
+        ~AsyncWriter() {
+            running = false;
+            variable.notify_one();
+            thread.join();
+        }
+
+        void push(LogRecord record) {
+            if (queue.push(std::move(record))) {
+                variable.notify_one();
+            } else {
+                dropped++;
+            }
+        }
+
+        /// @brief Wait until the writer thread writes all records pushed
+        /// before the call and flushes the output
+        void flush() {
+            size_t request = ++flushRequests;
+            while (flushesDone < request) {
+                variable.notify_one();
+                std::this_thread::yield();
+            }
+        }
+
+        size_t getDroppedCount() const {
+            return dropped;
+        }
+    };
+
+    std::atomic<AsyncWriter*> async_writer = nullptr;
+    /// @brief Number of threads may be using the async writer
+    std::atomic<int> async_producers = 0;
+    std::atomic<size_t> dropped_total = 0;
+
+    /// @brief Stops the writer before the file is closed
+    struct AsyncWriterGuard {
+        ~AsyncWriterGuard() {
+            Logger::shutdown();
+        }
+    } async_writer_guard;
+}
+
+LogMessage::~LogMessage() {
+    logger->log(level, ss.str());
+}
+
+Logger::Logger(std::string name) : name(std::move(name)) {
+}
+
+void Logger::log(LogLevel level, const std::string& name, std::string message) {
+    if (level < MIN_LOG_LEVEL) {
+        return;
+    }
+    LogRecord record {level, system_clock::now(), name, std::move(message)};
+    async_producers++;
+    if (auto writer = async_writer.load()) {
+        writer->push(std::move(record));
+        async_producers--;
+        return;
+    }
+    async_producers--;
+    std::lock_guard<std::mutex> lock(mutex);
+    write_line(format_record(record), true);
+}
+
+void Logger::init(const std::string& filename, bool async) {
     file.open(filename);
 
     time_t tm = std::time(nullptr);
     std::stringstream ss;
     ss << std::put_time(std::localtime(&tm), "%z");
-    utcOffset = ss.str();
+    utc_offset = ss.str();
+
+    if (async && async_writer == nullptr) {
+        async_writer = new AsyncWriter();
+    }
 }
 
 void Logger::flush() {
+    async_producers++;
+    if (auto writer = async_writer.load()) {
+        // the file is owned by the writer thread
+        writer->flush();
+        async_producers--;
+        return;
+    }
+    async_producers--;
     std::lock_guard<std::mutex> lock(mutex);
     file.flush();
 }
 
+void Logger::shutdown() {
+    auto writer = async_writer.exchange(nullptr);
+    if (writer == nullptr) {
+        return;
+    }
+    while (async_producers > 0) {
+        std::this_thread::yield();
+    }
+    dropped_total += writer->getDroppedCount();
+    delete writer;
+}
+
+size_t Logger::getDroppedCount() {
+    size_t count = dropped_total;
+    if (auto writer = async_writer.load()) {
+        count += writer->getDroppedCount();
+    }
+    return count;
+}
+
 void Logger::log(LogLevel level, std::string message) {
     log(level, name, std::move(message));
 }
@@ -1,12 +1,19 @@
 #pragma once
 
-#include <fstream>
-#include <mutex>
 #include <sstream>
+#include <string>
+#include <type_traits>
 
 namespace debug {
     enum class LogLevel { debug, info, warning, error };
 
+    /// @brief Messages with lesser level are removed at compile time
+#ifdef NDEBUG
+    inline constexpr LogLevel MIN_LOG_LEVEL = LogLevel::info;
+#else
+    inline constexpr LogLevel MIN_LOG_LEVEL = LogLevel::debug;
+#endif
+
     class Logger;
 
     class LogMessage {
@@ -26,39 +33,70 @@ namespace debug {
         }
     };
 
-    class Logger {
-        static std::mutex mutex;
-        static std::string utcOffset;
-        static std::ofstream file;
-        static unsigned moduleLen;
+    /// @brief Message of a level disabled at compile time. Does nothing
+    class NullLogMessage {
+    public:
+        template <class T>
+        NullLogMessage& operator<<(const T&) {
+            return *this;
+        }
+    };
 
+    template <LogLevel level>
+    using LogMessageFor = std::conditional_t<
+        (level >= MIN_LOG_LEVEL), LogMessage, NullLogMessage>;
+
+    class Logger {
         std::string name;
 
         static void log(
-            LogLevel level, const std::string& name, const std::string& message
+            LogLevel level, const std::string& name, std::string message
         );
+
+        template <LogLevel level>
+        LogMessageFor<level> message() {
+            if constexpr (level >= MIN_LOG_LEVEL) {
+                return LogMessage(this, level);
+            } else {
+                return NullLogMessage();
+            }
+        }
     public:
-        static void init(const std::string& filename);
+        /// @param filename log file
+        /// @param async write messages in a background thread. Producers
+        /// push records into a bounded lock-free queue, records are dropped
+        /// (and counted) when the queue is full
+        static void init(const std::string& filename, bool async = false);
+
+        /// @brief Write all logged messages and flush the file
         static void flush();
 
+        /// @brief Stop background writer thread (if async).
+        /// Logging remains available in synchronous mode
+        static void shutdown();
+
+        /// @brief Get number of messages dropped because of the async
+        /// queue overflow
+        static size_t getDroppedCount();
+
         Logger(std::string name);
 
         void log(LogLevel level, std::string message);
 
-        LogMessage debug() {
-            return LogMessage(this, LogLevel::debug);
+        LogMessageFor<LogLevel::debug> debug() {
+            return message<LogLevel::debug>();
         }
 
-        LogMessage info() {
-            return LogMessage(this, LogLevel::info);
+        LogMessageFor<LogLevel::info> info() {
+            return message<LogLevel::info>();
         }
 
-        LogMessage error() {
-            return LogMessage(this, LogLevel::error);
+        LogMessageFor<LogLevel::error> error() {
+            return message<LogLevel::error>();
         }
 
-        LogMessage warning() {
-            return LogMessage(this, LogLevel::warning);
+        LogMessageFor<LogLevel::warning> warning() {
+            return message<LogLevel::warning>();
         }
     };
 }
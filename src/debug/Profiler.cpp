@@ -0,0 +1,183 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#include "util/stringutil.hpp"
+
+using namespace debug;
+using namespace debug::profiler;
+
+std::atomic<bool> profiler::detail::tracing = false;
+
+namespace {
+    struct TraceEvent {
+        const Site* site;
+        int64_t start;
+        int64_t duration;
+    };
+
+    struct ThreadTrace {
+        int tid;
+        std::string name;
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+    };
+
+    struct SiteEntry {
+        Site* site;
+        SiteStats stats;
+    };
+
+    const detail::clock::time_point epoch = detail::clock::now();
+
+    std::mutex sitesMutex;
+    std::vector<SiteEntry>& get_sites() {
+        // sites are registered on first pass through their scopes
+        static std::vector<SiteEntry> sites;
+        return sites;
+    }
+
+    std::mutex threadsMutex;
+    std::vector<std::shared_ptr<ThreadTrace>> threads;
+
+    ThreadTrace& get_thread_trace() {
+        // kept alive by the threads list after the thread finishes
+        thread_local std::shared_ptr<ThreadTrace> trace = [] {
+            auto trace = std::make_shared<ThreadTrace>();
+            std::lock_guard lock(threadsMutex);
+            trace->tid = static_cast<int>(threads.size());
+            threads.push_back(trace);
+            return trace;
+        }();
+        return *trace;
+    }
+}
+
+static int bucket_of(int64_t time) {
+    int bucket = 0;
+    while (time > 0 && bucket < HISTOGRAM_BUCKETS - 1) {
+        time >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+Site::Site(const char* name) : name(name) {
+    std::lock_guard lock(sitesMutex);
+    get_sites().push_back(SiteEntry {this, SiteStats {name, 0, 0, 0, 0, 0, {}}});
+}
+
+int64_t profiler::detail::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               clock::now() - epoch
+    ).count();
+}
+
+void profiler::detail::add_trace_event(
+    const Site& site, int64_t start, int64_t end
+) {
+    auto& trace = get_thread_trace();
+    std::lock_guard lock(trace.mutex);
+    if (trace.events.size() < MAX_TRACE_EVENTS) {
+        trace.events.push_back(TraceEvent {&site, start, end - start});
+    }
+}
+
+void profiler::end_frame() {
+    std::lock_guard lock(sitesMutex);
+    for (auto& [site, stats] : get_sites()) {
+        int64_t time = site->frameTime.exchange(0, std::memory_order_relaxed);
+        uint32_t calls = site->frameCalls.exchange(0, std::memory_order_relaxed);
+        stats.lastTime = time;
+        stats.lastCalls = calls;
+        stats.maxTime = std::max(stats.maxTime, time);
+        stats.totalTime += time;
+        stats.frames++;
+        stats.histogram[bucket_of(time)]++;
+    }
+}
+
+void profiler::reset() {
+    {
+        std::lock_guard lock(sitesMutex);
+        for (auto& [site, stats] : get_sites()) {
+            stats = SiteStats {site->getName(), 0, 0, 0, 0, 0, {}};
+        }
+    }
+    std::lock_guard lock(threadsMutex);
+    for (auto& thread : threads) {
+        std::lock_guard threadLock(thread->mutex);
+        thread->events.clear();
+    }
+}
+
+std::vector<SiteStats> profiler::get_stats() {
+    std::vector<SiteStats> stats;
+    {
+        std::lock_guard lock(sitesMutex);
+        for (const auto& entry : get_sites()) {
+            stats.push_back(entry.stats);
+        }
+    }
+    std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+        return a.lastTime > b.lastTime;
+    });
+    return stats;
+}
+
+void profiler::set_thread_name(std::string name) {
+    auto& trace = get_thread_trace();
+    std::lock_guard lock(trace.mutex);
+    trace.name = std::move(name);
+}
+
+void profiler::set_tracing(bool flag) {
+    if (flag == is_tracing()) {
+        return;
+    }
+    if (flag) {
+        std::lock_guard lock(threadsMutex);
+        for (auto& thread : threads) {
+            std::lock_guard threadLock(thread->mutex);
+            thread->events.clear();
+        }
+    }
+    detail::tracing = flag;
+}
+
+void profiler::write_trace(std::ostream& stream) {
+    std::lock_guard lock(threadsMutex);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (auto& thread : threads) {
+        std::lock_guard threadLock(thread->mutex);
+        if (!thread->name.empty()) {
+            stream << (first ? "" : ",") << "\n"
+                   << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                   << "\"tid\":" << thread->tid << ",\"args\":{\"name\":"
+                   << util::escape(thread->name) << "}}";
+            first = false;
+        }
+        for (const auto& event : thread->events) {
+            stream << (first ? "" : ",") << "\n"
+                   << "{\"name\":" << util::escape(event.site->getName())
+                   << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->tid
+                   << ",\"ts\":" << event.start
+                   << ",\"dur\":" << event.duration << "}";
+            first = false;
+        }
+    }
+    stream << "\n]}\n";
+}
+
+void profiler::save_trace(const fs::path& file) {
+    std::ofstream stream(file, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("could not open file " + file.u8string());
+    }
+    write_trace(stream);
+}
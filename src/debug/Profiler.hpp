@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "typedefs.hpp"
+
+namespace fs = std::filesystem;
+
+/// @brief Engine hot paths instrumentation.
+///
+/// Scopes are placed with PROFILE_SCOPE("name") and compiled only when
+/// VOXELENGINE_PROFILER is defined (CMake option VOXELENGINE_PROFILER),
+/// otherwise the macro expands to nothing.
+///
+/// Time of each scope is summed over all threads during a frame and
+/// collected into a histogram on end_frame(). While tracing, every scope
+/// call is also recorded as a Chrome trace event (chrome://tracing,
+/// Perfetto).
+namespace debug::profiler {
+    /// @brief Number of histogram buckets. Bucket N contains frames where
+    /// scope time was in range [2^(N-1), 2^N) microseconds
+    inline constexpr int HISTOGRAM_BUCKETS = 24;
+    /// @brief Max number of trace events recorded by a single thread
+    inline constexpr size_t MAX_TRACE_EVENTS = 1 << 20;
+
+    using Histogram = std::array<uint32_t, HISTOGRAM_BUCKETS>;
+
+    /// @brief Statically allocated profiling point
+    class Site {
+        const char* name;
+        std::atomic<int64_t> frameTime {0};
+        std::atomic<uint32_t> frameCalls {0};
+
+        friend void end_frame();
+    public:
+        Site(const char* name);
+
+        const char* getName() const {
+            return name;
+        }
+
+        void add(int64_t time) {
+            frameTime.fetch_add(time, std::memory_order_relaxed);
+            frameCalls.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    /// @brief Site statistics collected by end_frame()
+    struct SiteStats {
+        std::string name;
+        /// @brief Time spent in the last frame in microseconds
+        int64_t lastTime;
+        /// @brief Calls count in the last frame
+        uint32_t lastCalls;
+        /// @brief Max time spent in a frame
+        int64_t maxTime;
+        /// @brief Total time spent in all frames
+        int64_t totalTime;
+        /// @brief Frames counted
+        uint64_t frames;
+        Histogram histogram;
+    };
+
+    namespace detail {
+        extern std::atomic<bool> tracing;
+
+        using clock = std::chrono::steady_clock;
+
+        /// @brief Get microseconds since the profiler initialization
+        int64_t now();
+
+        void add_trace_event(const Site& site, int64_t start, int64_t end);
+    }
+
+    /// @brief Measures time spent in scope
+    class Scope {
+        Site& site;
+        int64_t start;
+    public:
+        Scope(Site& site) : site(site), start(detail::now()) {
+        }
+
+        ~Scope() {
+            int64_t end = detail::now();
+            site.add(end - start);
+            if (detail::tracing.load(std::memory_order_relaxed)) {
+                detail::add_trace_event(site, start, end);
+            }
+        }
+    };
+
+    /// @brief Collect sites time of the finished frame into histograms.
+    /// Called once per frame by the engine main loop
+    void end_frame();
+
+    /// @brief Clear collected statistics and trace
+    void reset();
+
+    /// @brief Get statistics of all sites sorted by last frame time
+    std::vector<SiteStats> get_stats();
+
+    /// @brief Set current thread name shown in trace
+    void set_thread_name(std::string name);
+
+    /// @brief Start or stop recording trace events.
+    /// Recorded events are cleared on start
+    void set_tracing(bool flag);
+
+    inline bool is_tracing() {
+        return detail::tracing.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Write recorded trace in Chrome trace event format
+    void write_trace(std::ostream& stream);
+
+    /// @brief Save recorded trace as Chrome trace JSON file
+    void save_trace(const fs::path& file);
+
+    /// @brief Check if engine is built with scopes enabled
+    constexpr bool is_enabled() {
+#ifdef VOXELENGINE_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+#define PROFILE_CONCAT_IMPL(A, B) A##B
+#define PROFILE_CONCAT(A, B) PROFILE_CONCAT_IMPL(A, B)
+
+#ifdef VOXELENGINE_PROFILER
+#define PROFILE_SCOPE(NAME)                                               \
+    static debug::profiler::Site PROFILE_CONCAT(profile_site_, __LINE__)( \
+        NAME                                                              \
+    );                                                                    \
+    debug::profiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(      \
+        PROFILE_CONCAT(profile_site_, __LINE__)                           \
+    )
+#else
+#define PROFILE_SCOPE(NAME)
+#endif
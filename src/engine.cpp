@@ -3,6 +3,7 @@
 #define GLEW_STATIC
 
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "assets/AssetsLoader.hpp"
 #include "audio/audio.hpp"
 #include "coders/GLSLExtension.hpp"
@@ -12,6 +13,7 @@
 #include "coders/commons.hpp"
 #include "content/Content.hpp"
 #include "content/ContentBuilder.hpp"
+#include "content/ContentCache.hpp"
 #include "content/ContentLoader.hpp"
 #include "core_defs.hpp"
 #include "files/files.hpp"
@@ -30,8 +32,10 @@
 #include "logic/EngineController.hpp"
 #include "logic/CommandsInterpreter.hpp"
 #include "logic/scripting/scripting.hpp"
+#include "util/hash.hpp"
 #include "util/listutil.hpp"
 #include "util/platform.hpp"
+#include "util/stringutil.hpp"
 #include "window/Camera.hpp"
 #include "window/Events.hpp"
 #include "window/input.hpp"
@@ -173,6 +177,7 @@ void Engine::mainloop() {
     lastTime = Window::time();
     
     logger.info() << "engine started";
+    debug::profiler::set_thread_name("main");
     while (!Window::isShouldClose()){
         assert(screen != nullptr);
         updateTimers();
@@ -192,6 +197,7 @@ void Engine::mainloop() {
         );
 
         processPostRunnables();
+        debug::profiler::end_frame();
 
         Window::swapBuffers();
         Events::pollEvents();
@@ -265,23 +271,15 @@ void Engine::loadAssets() {
 
     auto new_assets = std::make_unique<Assets>();
     AssetsLoader loader(new_assets.get(), resPaths.get());
+    loader.setCacheFolder(paths->getCacheFolder());
     AssetsLoader::addDefaults(loader, content.get());
 
-    // no need
-    // correct log messages order is more useful
-    bool threading = false; // look at two upper lines
-    if (threading) {
-        auto task = loader.startTask([=](){});
-        task->waitForEnd();
-    } else {
-        try {
-            while (loader.hasNext()) {
-                loader.loadNext();
-            }
-        } catch (const assetload::error& err) {
-            new_assets.reset();
-            throw;
-        }
+    try {
+        // files are decoded in parallel, log messages keep the order
+        loader.loadAll();
+    } catch (const assetload::error& err) {
+        new_assets.reset();
+        throw;
     }
     assets = std::move(new_assets);
     
@@ -352,15 +350,29 @@ void Engine::loadContent() {
     }
     resPaths = std::make_unique<ResPaths>(resdir, resRoots);
 
+    // Parsed definitions cache is separate for each packs set
+    util::Hasher64 packsHash;
+    packsHash.update(corePack.folder.u8string());
+    for (const auto& pack : contentPacks) {
+        packsHash.update(pack.folder.u8string());
+    }
+    ContentCache cache(
+        paths->getCacheFolder() /
+        fs::u8path("content/" + util::tohex(packsHash.value()) + ".bin")
+    );
+
     // Load content
     {
-        ContentLoader(&corePack, contentBuilder, *resPaths).load();
+        ContentLoader(&corePack, contentBuilder, *resPaths, &cache).load();
         load_configs(corePack.folder);
     }
     for (auto& pack : contentPacks) {
-        ContentLoader(&pack, contentBuilder, *resPaths).load();
+        ContentLoader(&pack, contentBuilder, *resPaths, &cache).load();
         load_configs(pack.folder);
     }
+    cache.save();
+    logger.info() << "content definitions cache: " << cache.getHits()
+                  << " hits, " << cache.getMisses() << " misses";
 
     content = contentBuilder.build();
 
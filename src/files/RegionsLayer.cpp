@@ -2,6 +2,7 @@
 
 #include <cstring>
 
+#include "debug/Profiler.hpp"
 #include "util/data_io.hpp"
 
 #define REGION_FORMAT_MAGIC ".VOXREG"
@@ -179,6 +180,7 @@ ubyte* RegionsLayer::getData(int x, int z, uint32_t& size, uint32_t& srcSize) {
 }
 
 void RegionsLayer::writeRegion(int x, int z, WorldRegion* entry) {
+    PROFILE_SCOPE("regions.write");
     fs::path filename = folder / get_region_filename(x, z);
 
     glm::ivec2 regcoord(x, z);
@@ -234,6 +236,7 @@ void RegionsLayer::writeRegion(int x, int z, WorldRegion* entry) {
 std::unique_ptr<ubyte[]> RegionsLayer::readChunkData(
     int x, int z, uint32_t& size, uint32_t& srcSize, regfile* rfile
 ) {
+    PROFILE_SCOPE("regions.read");
     int regionX, regionZ, localX, localZ;
     calc_reg_coords(x, z, regionX, regionZ, localX, localZ);
     int chunkIndex = localZ * REGION_SIZE + localX;
@@ -167,6 +167,7 @@ std::shared_ptr<Task> WorldConverter::startTask(
         [=]() { return std::make_shared<ConverterWorker>(converter); },
         [=](int&) {}
     );
+    pool->setPriority(util::JobPriority::LOW);
     auto& converterTasks = converter->tasks;
     while (!converterTasks.empty()) {
         ConvertTask task = std::move(converterTasks.front());
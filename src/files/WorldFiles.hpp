@@ -80,5 +80,9 @@ public:
         return doWriteLights;
     }
 
+    bool isGeneratorTestMode() const {
+        return generatorTestMode;
+    }
+
     static const inline std::string WORLD_FILE = "world.json";
 };
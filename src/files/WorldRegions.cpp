@@ -5,12 +5,14 @@
 #include <vector>
 
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "coders/json.hpp"
 #include "coders/byte_utils.hpp"
 #include "coders/rle.hpp"
 #include "coders/binary_json.hpp"
 #include "items/Inventory.hpp"
 #include "maths/voxmaths.hpp"
+#include "objects/entities_io.hpp"
 #include "util/data_io.hpp"
 
 #define REGION_FORMAT_MAGIC ".VOXREG"
@@ -125,9 +127,13 @@ static std::unique_ptr<ubyte[]> write_inventories(
     for (auto& entry : inventories) {
         builder.putInt32(entry.first);
         auto map = entry.second->serialize();
-        auto bytes = json::to_binary(map, true);
-        builder.putInt32(bytes.size());
-        builder.put(bytes.data(), bytes.size());
+        // compressed size is written after the document
+        size_t sizePosition = builder.size();
+        builder.putInt32(0);
+        json::to_binary(builder, map, true);
+        builder.setInt32(
+            sizePosition, builder.size() - sizePosition - sizeof(int32_t)
+        );
     }
     auto datavec = builder.data();
     datasize = builder.size();
@@ -138,6 +144,8 @@ static std::unique_ptr<ubyte[]> write_inventories(
 
 static ChunkInventoriesMap load_inventories(const ubyte* src, uint32_t size) {
     ChunkInventoriesMap inventories;
+    // documents are dropped after inventories deserialization
+    dv::ArenaScope arena;
     ByteReader reader(src, size);
     auto count = reader.getInt32();
     for (int i = 0; i < count; i++) {
@@ -153,6 +161,7 @@ static ChunkInventoriesMap load_inventories(const ubyte* src, uint32_t size) {
 }
 
 void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
+    PROFILE_SCOPE("regions.put");
     if (generatorTestMode) {
         return;
     }
@@ -195,9 +204,7 @@ void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
     // Writing entities
     if (!entitiesData.empty()) {
         auto data = std::make_unique<ubyte[]>(entitiesData.size());
-        for (size_t i = 0; i < entitiesData.size(); i++) {
-            data[i] = entitiesData[i];
-        }
+        std::memcpy(data.get(), entitiesData.data(), entitiesData.size());
         put(chunk->x,
             chunk->z,
             REGION_LAYER_ENTITIES,
@@ -216,6 +223,7 @@ void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
 }
 
 std::unique_ptr<ubyte[]> WorldRegions::getVoxels(int x, int z) {
+    PROFILE_SCOPE("regions.voxels");
     uint32_t size;
     uint32_t srcSize;
     auto& layer = layers[REGION_LAYER_VOXELS];
@@ -335,21 +343,19 @@ void WorldRegions::processBlocksData(int x, int z, const BlockDataProc& func) {
     }
 }
 
-dv::value WorldRegions::fetchEntities(int x, int z) {
+std::optional<std::vector<SavedEntity>> WorldRegions::fetchEntities(
+    int x, int z
+) {
     if (generatorTestMode) {
-        return nullptr;
+        return std::nullopt;
     }
     uint32_t bytesSize;
     uint32_t srcSize;
     const ubyte* data = layers[REGION_LAYER_ENTITIES].getData(x, z, bytesSize, srcSize);
     if (data == nullptr) {
-        return nullptr;
-    }
-    auto map = json::from_binary(data, bytesSize);
-    if (map.empty()) {
-        return nullptr;
+        return std::nullopt;
     }
-    return map;
+    return entities_io::decode(data, bytesSize);
 }
 
 void WorldRegions::processRegion(
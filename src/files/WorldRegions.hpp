@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <unordered_map>
 
 #include "typedefs.hpp"
@@ -21,6 +22,8 @@
 
 namespace fs = std::filesystem;
 
+struct SavedEntity;
+
 inline constexpr uint REGION_HEADER_SIZE = 10;
 
 inline constexpr uint REGION_SIZE_BIT = 5;
@@ -223,8 +226,9 @@ public:
     /// @brief Load saved entities data for chunk
     /// @param x chunk.x
     /// @param z chunk.z
-    /// @return map with entities list as "data"
-    dv::value fetchEntities(int x, int z);
+    /// @return saved entities or std::nullopt if chunk has no entities data
+    /// @throws std::runtime_error - invalid entities data
+    std::optional<std::vector<SavedEntity>> fetchEntities(int x, int z);
 
     /// @brief Load, process and save processed region chunks data
     /// @param x region X
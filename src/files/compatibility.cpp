@@ -106,5 +106,5 @@ util::Buffer<ubyte> compatibility::convert_region_2to3(
     for (size_t i = 0; i < REGION_CHUNKS; i++) {
         builder.putInt32(offsets[i]);
     }
-    return util::Buffer<ubyte>(builder.build().data(), builder.size());
+    return util::Buffer<ubyte>(builder.data(), builder.size());
 }
@@ -18,6 +18,7 @@ static inline auto SCREENSHOTS_FOLDER = std::filesystem::u8path("screenshots");
 static inline auto CONTENT_FOLDER = std::filesystem::u8path("content");
 static inline auto WORLDS_FOLDER = std::filesystem::u8path("worlds");
 static inline auto CONFIG_FOLDER = std::filesystem::u8path("config");
+static inline auto CACHE_FOLDER = std::filesystem::u8path("cache");
 static inline auto EXPORT_FOLDER = std::filesystem::u8path("export");
 static inline auto CONTROLS_FILE = std::filesystem::u8path("controls.toml");
 static inline auto SETTINGS_FILE = std::filesystem::u8path("settings.toml");
@@ -104,6 +105,10 @@ std::filesystem::path EnginePaths::getConfigFolder() const {
     return userFilesFolder / CONFIG_FOLDER;
 }
 
+std::filesystem::path EnginePaths::getCacheFolder() const {
+    return userFilesFolder / CACHE_FOLDER;
+}
+
 std::filesystem::path EnginePaths::getCurrentWorldFolder() {
     return currentWorldFolder;
 }
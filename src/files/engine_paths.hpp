@@ -29,6 +29,9 @@ public:
     std::filesystem::path getWorldFolderByName(const std::string& name);
     std::filesystem::path getWorldsFolder() const;
     std::filesystem::path getConfigFolder() const;
+    /// @brief Get folder for data which may be deleted at any moment
+    /// (rebuilt from sources)
+    std::filesystem::path getCacheFolder() const;
 
     void setCurrentWorldFolder(std::filesystem::path folder);
     std::filesystem::path getCurrentWorldFolder();
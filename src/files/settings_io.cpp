@@ -64,6 +64,7 @@ SettingsHandler::SettingsHandler(EngineSettings& settings) {
     builder.add("load-distance", &settings.chunks.loadDistance);
     builder.add("load-speed", &settings.chunks.loadSpeed);
     builder.add("padding", &settings.chunks.padding);
+    builder.add("prototypes-spill", &settings.chunks.prototypesSpill);
 
     builder.section("graphics");
     builder.add("fog-curve", &settings.graphics.fogCurve);
@@ -73,6 +74,7 @@ SettingsHandler::SettingsHandler(EngineSettings& settings) {
     builder.add("skybox-resolution", &settings.graphics.skyboxResolution);
     builder.add("chunk-max-vertices", &settings.graphics.chunkMaxVertices);
     builder.add("chunk-max-renderers", &settings.graphics.chunkMaxRenderers);
+    builder.add("greedy-meshing", &settings.graphics.greedyMeshing);
 
     builder.section("ui");
     builder.add("language", &settings.ui.language);
@@ -14,20 +14,35 @@
 ContentGfxCache::ContentGfxCache(const Content* content, const Assets& assets)
     : content(content) {
     auto indices = content->getIndices();
-    sideregions = std::make_unique<UVRegion[]>(indices->blocks.count() * 6);
+    meshInfo = std::make_unique<BlockMeshInfo[]>(indices->blocks.count());
     const auto& atlas = assets.require<Atlas>("blocks");
 
     const auto& blocks = indices->blocks.getIterable();
     for (blockid_t i = 0; i < blocks.size(); i++) {
         auto def = blocks[i];
+        auto& info = meshInfo[i];
         for (uint side = 0; side < 6; side++) {
             const std::string& tex = def->textureFaces[side];
             if (atlas.has(tex)) {
-                sideregions[i * 6 + side] = atlas.get(tex);
+                info.textureFaces[side] = atlas.get(tex);
             } else if (atlas.has(TEXTURE_NOTFOUND)) {
-                sideregions[i * 6 + side] = atlas.get(TEXTURE_NOTFOUND);
+                info.textureFaces[side] = atlas.get(TEXTURE_NOTFOUND);
             }
         }
+        info.model = def->model;
+        info.drawGroup = def->drawGroup;
+        info.lightPassing = def->lightPassing;
+        info.shadeless = def->shadeless;
+        info.ambientOcclusion = def->ambientOcclusion;
+        info.rotatable = def->rotatable;
+        info.extended = def->rt.extended;
+        if (!def->rt.solid) {
+            info.occlusion = BlockOcclusion::none;
+        } else if (def->lightPassing) {
+            info.occlusion = BlockOcclusion::group;
+        } else {
+            info.occlusion = BlockOcclusion::full;
+        }
         if (def->model == BlockModel::custom) {
             auto model = assets.require<model::Model>(def->modelName);
             // temporary dirty fix tbh
@@ -7,26 +7,68 @@
 #include <unordered_map>
 
 #include "graphics/commons/Model.hpp"
+#include "maths/UVRegion.hpp"
+#include "voxels/Block.hpp"
 
 class Content;
 class Assets;
-struct UVRegion;
 
 namespace model {
     struct Model;
 }
 
+/// @brief Defines which neighbour block faces are hidden by the block
+enum class BlockOcclusion : ubyte {
+    /// @brief Does not hide neighbour faces (non-cube models, air)
+    none,
+    /// @brief Hides faces of blocks from the same draw group only
+    group,
+    /// @brief Opaque cube hiding all neighbour faces
+    full
+};
+
+/// @brief Compact block info used by the chunks mesher to avoid
+/// scattered Block definitions access per voxel
+struct BlockMeshInfo {
+    /// @brief Block sides uv regions: -x,x, -y,y, -z,z
+    UVRegion textureFaces[6];
+    BlockModel model = BlockModel::none;
+    BlockOcclusion occlusion = BlockOcclusion::none;
+    ubyte drawGroup = 0;
+    bool lightPassing = true;
+    bool shadeless = false;
+    bool ambientOcclusion = false;
+    bool rotatable = false;
+    bool extended = false;
+
+    /// @brief Check if a face of block of the draw group is visible
+    /// through this block
+    inline bool isOpenFor(ubyte group) const {
+        return occlusion == BlockOcclusion::none ||
+               (occlusion == BlockOcclusion::group && drawGroup != group);
+    }
+};
+
 class ContentGfxCache {
     const Content* content;
-    // array of block sides uv regions (6 per block)
-    std::unique_ptr<UVRegion[]> sideregions;
+    // array of mesher block info indexed by block id
+    std::unique_ptr<BlockMeshInfo[]> meshInfo;
     std::unordered_map<blockid_t, model::Model> models;
 public:
     ContentGfxCache(const Content* content, const Assets& assets);
     ~ContentGfxCache();
 
     inline const UVRegion& getRegion(blockid_t id, int side) const {
-        return sideregions[id * 6 + side];
+        return meshInfo[id].textureFaces[side];
+    }
+
+    inline const BlockMeshInfo& getMeshInfo(blockid_t id) const {
+        return meshInfo[id];
+    }
+
+    /// @return array of mesher block info indexed by block id
+    const BlockMeshInfo* getMeshInfos() const {
+        return meshInfo.get();
     }
 
     const model::Model& getModel(blockid_t id) const;
@@ -1,5 +1,6 @@
 #include "audio/audio.hpp"
 #include "delegates.hpp"
+#include "debug/Profiler.hpp"
 #include "engine.hpp"
 #include "settings.hpp"
 #include "hud.hpp"
@@ -32,6 +33,8 @@
 
 using namespace gui;
 
+static constexpr size_t PROFILER_LINES = 5;
+
 static std::shared_ptr<Label> create_label(wstringsupplier supplier) {
     auto label = std::make_shared<Label>(L"-");
     label->textSupplier(std::move(supplier));
@@ -83,6 +86,26 @@ std::shared_ptr<UINode> create_debug_panel(
     panel->add(create_label([]() {
         return L"lua-stack: " + std::to_wstring(scripting::get_values_on_stack());
     }));
+    if constexpr (debug::profiler::is_enabled()) {
+        static std::vector<debug::profiler::SiteStats> profilerStats;
+        panel->listenInterval(0.5f, []() {
+            profilerStats = debug::profiler::get_stats();
+        });
+        for (size_t i = 0; i < PROFILER_LINES; i++) {
+            panel->add(create_label([i]() {
+                if (i >= profilerStats.size()) {
+                    return std::wstring {L"-"};
+                }
+                const auto& stats = profilerStats[i];
+                int64_t avg = stats.totalTime / std::max<uint64_t>(1, stats.frames);
+                return util::str2wstr_utf8(stats.name) + L": " +
+                       std::to_wstring(stats.lastTime) + L" us (" +
+                       std::to_wstring(stats.lastCalls) + L") avg: " +
+                       std::to_wstring(avg) + L" max: " +
+                       std::to_wstring(stats.maxTime);
+            }));
+        }
+    }
     panel->add(create_label([=]() {
         auto& settings = engine->getSettings();
         bool culling = settings.graphics.frustumCulling.get();
@@ -57,6 +57,9 @@ LevelScreen::LevelScreen(Engine* engine, std::unique_ptr<Level> levelPtr)
         controller->getLevel()->chunks->saveAndClear();
         worldRenderer->clear();
     }));
+    keepAlive(settings.graphics.greedyMeshing.observe([=](bool) {
+        worldRenderer->clear();
+    }));
     keepAlive(settings.camera.fov.observe([=](double value) {
         controller->getPlayer()->fpCamera->setFov(glm::radians(value));
     }));
@@ -49,6 +49,10 @@ ImageData* Atlas::getImage() const {
     return image.get();
 }
 
+const std::unordered_map<std::string, UVRegion>& Atlas::getRegions() const {
+    return regions;
+}
+
 void AtlasBuilder::add(const std::string& name, std::unique_ptr<ImageData> image) {
     entries.push_back(atlasentry{name, std::shared_ptr<ImageData>(image.release())});
     names.insert(name);
@@ -5,6 +5,7 @@
 #include "maths/UVRegion.hpp"
 #include "constants.hpp"
 #include "content/Content.hpp"
+#include "debug/Profiler.hpp"
 #include "voxels/Chunks.hpp"
 #include "lighting/Lightmap.hpp"
 #include "frontend/ContentGfxCache.hpp"
@@ -13,8 +14,20 @@
 #include <glm/glm.hpp>
 
 const uint BlocksRenderer::VERTEX_SIZE = 6;
+const uint BlocksRenderer::GREEDY_VERTEX_SIZE = 10;
 const glm::vec3 BlocksRenderer::SUN_VECTOR (0.411934f, 0.863868f, -0.279161f);
 
+static const vattr VERTEX_ATTRS[] { {3}, {2}, {1}, {0} };
+static const vattr GREEDY_VERTEX_ATTRS[] { {3}, {2}, {1}, {4}, {0} };
+
+inline uint32_t compress_light(const glm::vec4& light) {
+    uint32_t compressed = (static_cast<uint32_t>(light.r * 255) & 0xff) << 24;
+    compressed |= (static_cast<uint32_t>(light.g * 255) & 0xff) << 16;
+    compressed |= (static_cast<uint32_t>(light.b * 255) & 0xff) << 8;
+    compressed |= (static_cast<uint32_t>(light.a * 255) & 0xff);
+    return compressed;
+}
+
 BlocksRenderer::BlocksRenderer(
     size_t capacity,
     const Content& content,
@@ -30,11 +43,9 @@ BlocksRenderer::BlocksRenderer(
     cache(cache),
     settings(settings) 
 {
-    voxelsBuffer = std::make_unique<VoxelsVolume>(
-        CHUNK_W + voxelBufferPadding*2, 
-        CHUNK_H, 
-        CHUNK_D + voxelBufferPadding*2);
+    openFaces = std::make_unique<ubyte[]>(CHUNK_VOL);
     blockDefsCache = content.getIndices()->blocks.getDefs();
+    meshInfo = cache.getMeshInfos();
 }
 
 BlocksRenderer::~BlocksRenderer() {
@@ -56,12 +67,47 @@ void BlocksRenderer::vertex(
         uint32_t integer;
     } compressed;
 
-    compressed.integer = (static_cast<uint32_t>(light.r * 255) & 0xff) << 24;
-    compressed.integer |= (static_cast<uint32_t>(light.g * 255) & 0xff) << 16;
-    compressed.integer |= (static_cast<uint32_t>(light.b * 255) & 0xff) << 8;
-    compressed.integer |= (static_cast<uint32_t>(light.a * 255) & 0xff);
+    compressed.integer = compress_light(light);
 
     vertexBuffer[vertexOffset++] = compressed.floating;
+
+    if (greedyMeshing) {
+        // zero region means no texture repeat
+        vertexBuffer[vertexOffset++] = 0.0f;
+        vertexBuffer[vertexOffset++] = 0.0f;
+        vertexBuffer[vertexOffset++] = 0.0f;
+        vertexBuffer[vertexOffset++] = 0.0f;
+    }
+}
+
+/// @brief Greedy meshing vertex with texture coords in sprite units
+void BlocksRenderer::vertex(
+    const glm::vec3& coord,
+    float u,
+    float v,
+    uint32_t light,
+    const UVRegion& region
+) {
+    vertexBuffer[vertexOffset++] = coord.x;
+    vertexBuffer[vertexOffset++] = coord.y;
+    vertexBuffer[vertexOffset++] = coord.z;
+
+    vertexBuffer[vertexOffset++] = u;
+    vertexBuffer[vertexOffset++] = v;
+
+    union {
+        float floating;
+        uint32_t integer;
+    } compressed;
+
+    compressed.integer = light;
+
+    vertexBuffer[vertexOffset++] = compressed.floating;
+
+    vertexBuffer[vertexOffset++] = region.u1;
+    vertexBuffer[vertexOffset++] = region.v1;
+    vertexBuffer[vertexOffset++] = region.u2 - region.u1;
+    vertexBuffer[vertexOffset++] = region.v2 - region.v1;
 }
 
 void BlocksRenderer::index(int a, int b, int c, int d, int e, int f) {
@@ -85,7 +131,7 @@ void BlocksRenderer::face(
     const glm::vec4(&lights)[4],
     const glm::vec4& tint
 ) {
-    if (vertexOffset + BlocksRenderer::VERTEX_SIZE * 4 > capacity) {
+    if (vertexOffset + vertexSize * 4 > capacity) {
         overflow = true;
         return;
     }
@@ -125,7 +171,7 @@ void BlocksRenderer::faceAO(
     const UVRegion& region,
     bool lights
 ) {
-    if (vertexOffset + BlocksRenderer::VERTEX_SIZE * 4 > capacity) {
+    if (vertexOffset + vertexSize * 4 > capacity) {
         overflow = true;
         return;
     }
@@ -163,7 +209,7 @@ void BlocksRenderer::face(
     glm::vec4 tint,
     bool lights
 ) {
-    if (vertexOffset + BlocksRenderer::VERTEX_SIZE * 4 > capacity) {
+    if (vertexOffset + vertexSize * 4 > capacity) {
         overflow = true;
         return;
     }
@@ -288,7 +334,7 @@ void BlocksRenderer::blockCustomModel(
 
     const auto& model = cache.getModel(block->rt.id);
     for (const auto& mesh : model.meshes) {
-        if (vertexOffset + BlocksRenderer::VERTEX_SIZE * mesh.vertices.size() > capacity) {
+        if (vertexOffset + vertexSize * mesh.vertices.size() > capacity) {
             overflow = true;
             return;
         }
@@ -325,11 +371,10 @@ void BlocksRenderer::blockCube(
     const UVRegion(&texfaces)[6], 
     const Block& block, 
     blockstate states,
+    ubyte faces,
     bool lights,
     bool ao
 ) {
-    ubyte group = block.drawGroup;
-
     glm::ivec3 X(1, 0, 0);
     glm::ivec3 Y(0, 1, 0);
     glm::ivec3 Z(0, 0, 1);
@@ -343,55 +388,241 @@ void BlocksRenderer::blockCube(
     }
     
     if (ao) {
-        if (isOpen(coord + Z, group)) {
+        if (isOpen(faces, Z)) {
             faceAO(coord, X, Y, Z, texfaces[5], lights);
         }
-        if (isOpen(coord - Z, group)) {
+        if (isOpen(faces, -Z)) {
             faceAO(coord, -X, Y, -Z, texfaces[4], lights);
         }
-        if (isOpen(coord + Y, group)) {
+        if (isOpen(faces, Y)) {
             faceAO(coord, X, -Z, Y, texfaces[3], lights);
         }
-        if (isOpen(coord - Y, group)) {
+        if (isOpen(faces, -Y)) {
             faceAO(coord, X, Z, -Y, texfaces[2], lights);
         }
-        if (isOpen(coord + X, group)) {
+        if (isOpen(faces, X)) {
             faceAO(coord, -Z, Y, X, texfaces[1], lights);
         }
-        if (isOpen(coord - X, group)) {
+        if (isOpen(faces, -X)) {
             faceAO(coord, Z, Y, -X, texfaces[0], lights);
         }
     } else {
-        if (isOpen(coord + Z, group)) {
+        if (isOpen(faces, Z)) {
             face(coord, X, Y, Z, texfaces[5], pickLight(coord + Z), lights);
         }
-        if (isOpen(coord - Z, group)) {
+        if (isOpen(faces, -Z)) {
             face(coord, -X, Y, -Z, texfaces[4], pickLight(coord - Z), lights);
         }
-        if (isOpen(coord + Y, group)) {
+        if (isOpen(faces, Y)) {
             face(coord, X, -Z, Y, texfaces[3], pickLight(coord + Y), lights);
         }
-        if (isOpen(coord - Y, group)) {
+        if (isOpen(faces, -Y)) {
             face(coord, X, Z, -Y, texfaces[2], pickLight(coord - Y), lights);
         }
-        if (isOpen(coord + X, group)) {
+        if (isOpen(faces, X)) {
             face(coord, -Z, Y, X, texfaces[1], pickLight(coord + X), lights);
         }
-        if (isOpen(coord - X, group)) {
+        if (isOpen(faces, -X)) {
             face(coord, Z, Y, -X, texfaces[0], pickLight(coord - X), lights);
         }
     }
 }
 
+namespace {
+    /// @brief Face emitted by greedy meshing with per-corner lights
+    struct GreedyCell {
+        blockid_t id;
+        uint32_t lights[4];
+
+        inline bool operator==(const GreedyCell& o) const {
+            return id == o.id && lights[0] == o.lights[0] &&
+                   lights[1] == o.lights[1] && lights[2] == o.lights[2] &&
+                   lights[3] == o.lights[3];
+        }
+
+        /// @brief Check if all corners have the same light. Only such
+        /// cells are merged to not stretch a single block light gradient
+        inline bool isUniform() const {
+            return lights[0] == lights[1] && lights[0] == lights[2] &&
+                   lights[0] == lights[3];
+        }
+    };
+
+    /// @brief Cube face axes in the same order and orientation as used
+    /// by BlocksRenderer::blockCube
+    struct GreedyFace {
+        glm::ivec3 axisX;
+        glm::ivec3 axisY;
+        glm::ivec3 axisZ;
+        uint side;
+    };
+
+    const GreedyFace GREEDY_FACES[6] {
+        {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, FACE_PZ},
+        {{-1, 0, 0}, {0, 1, 0}, {0, 0, -1}, FACE_MZ},
+        {{1, 0, 0}, {0, 0, -1}, {0, 1, 0}, FACE_PY},
+        {{1, 0, 0}, {0, 0, 1}, {0, -1, 0}, FACE_MY},
+        {{0, 0, -1}, {0, 1, 0}, {1, 0, 0}, FACE_PX},
+        {{0, 0, 1}, {0, 1, 0}, {-1, 0, 0}, FACE_MX},
+    };
+
+    inline int axis_index(const glm::ivec3& axis) {
+        return axis.x ? 0 : (axis.y ? 1 : 2);
+    }
+}
+
+void BlocksRenderer::greedyCubes(
+    const voxel* voxels, ubyte group, int begin, int end
+) {
+    const int yBegin = begin / (CHUNK_W * CHUNK_D);
+    const int yEnd = end / (CHUNK_W * CHUNK_D) + 1;
+    const glm::ivec3 origin(0, yBegin, 0);
+    const glm::ivec3 size(CHUNK_W, yEnd - yBegin, CHUNK_D);
+
+    // corners order matches faceAO vertices order
+    const glm::vec2 corners[4] {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+    std::vector<GreedyCell> mask;
+    for (const auto& face : GREEDY_FACES) {
+        const glm::ivec3& X = face.axisX;
+        const glm::ivec3& Y = face.axisY;
+        const glm::ivec3& Z = face.axisZ;
+        int ui = axis_index(X);
+        int vi = axis_index(Y);
+        int ni = axis_index(Z);
+        int su = size[ui];
+        int sv = size[vi];
+        mask.assign(su * sv, GreedyCell {});
+
+        glm::vec3 axisX(X);
+        glm::vec3 axisY(Y);
+        glm::vec3 axisZ(Z);
+        float d = glm::dot(axisZ, SUN_VECTOR);
+        d = 0.8f + d * 0.2f;
+
+        for (int slice = origin[ni]; slice < origin[ni] + size[ni]; slice++) {
+            bool empty = true;
+            for (int j = 0; j < sv; j++) {
+                for (int i = 0; i < su; i++) {
+                    glm::ivec3 coord;
+                    coord[ui] = origin[ui] + i;
+                    coord[vi] = origin[vi] + j;
+                    coord[ni] = slice;
+
+                    auto& cell = mask[j * su + i];
+                    cell.id = 0;
+
+                    uint index = vox_index(coord.x, coord.y, coord.z);
+                    const voxel& vox = voxels[index];
+                    if (vox.id == 0 || vox.state.segment) {
+                        continue;
+                    }
+                    const auto& info = meshInfo[vox.id];
+                    if (info.drawGroup != group || !isGreedyMeshable(info) ||
+                        !isOpen(openFaces[index], Z)) {
+                        continue;
+                    }
+                    bool lights = !info.shadeless;
+                    if (info.ambientOcclusion && lights) {
+                        glm::vec3 center(coord);
+                        for (int k = 0; k < 4; k++) {
+                            auto pos = center +
+                                       (axisX * corners[k].x +
+                                        axisY * corners[k].y + axisZ) * 0.5f +
+                                       axisZ * 0.5f + (axisX + axisY) * 0.5f;
+                            cell.lights[k] = compress_light(pickSoftLight(
+                                glm::ivec3(
+                                    std::round(pos.x),
+                                    std::round(pos.y),
+                                    std::round(pos.z)
+                                ),
+                                X,
+                                Y
+                            ) * d);
+                        }
+                    } else {
+                        glm::vec4 tint(1.0f);
+                        if (!info.ambientOcclusion) {
+                            tint = pickLight(coord + Z);
+                            if (lights) {
+                                tint *= d;
+                            }
+                        }
+                        uint32_t light = compress_light(tint);
+                        cell.lights[0] = cell.lights[1] = light;
+                        cell.lights[2] = cell.lights[3] = light;
+                    }
+                    cell.id = vox.id;
+                    empty = false;
+                }
+            }
+            if (empty) {
+                continue;
+            }
+            for (int j = 0; j < sv; j++) {
+                for (int i = 0; i < su;) {
+                    const GreedyCell cell = mask[j * su + i];
+                    if (cell.id == 0) {
+                        i++;
+                        continue;
+                    }
+                    bool mergeable = cell.isUniform();
+                    int w = 1;
+                    while (mergeable && i + w < su &&
+                           mask[j * su + i + w] == cell) {
+                        w++;
+                    }
+                    int h = 1;
+                    for (; mergeable && j + h < sv; h++) {
+                        bool fits = true;
+                        for (int k = 0; k < w; k++) {
+                            if (!(mask[(j + h) * su + i + k] == cell)) {
+                                fits = false;
+                                break;
+                            }
+                        }
+                        if (!fits) {
+                            break;
+                        }
+                    }
+                    for (int dy = 0; dy < h; dy++) {
+                        for (int dx = 0; dx < w; dx++) {
+                            mask[(j + dy) * su + i + dx].id = 0;
+                        }
+                    }
+                    if (vertexOffset + vertexSize * 4 > capacity) {
+                        overflow = true;
+                        return;
+                    }
+                    glm::vec3 coord;
+                    coord[ui] = origin[ui] + i + (w - 1) * 0.5f;
+                    coord[vi] = origin[vi] + j + (h - 1) * 0.5f;
+                    coord[ni] = slice;
+
+                    const auto& region = meshInfo[cell.id].textureFaces[face.side];
+                    auto sx = axisX * static_cast<float>(w);
+                    auto sy = axisY * static_cast<float>(h);
+                    float s = 0.5f;
+                    vertex(coord + (-sx - sy + axisZ) * s, 0, 0, cell.lights[0], region);
+                    vertex(coord + ( sx - sy + axisZ) * s, w, 0, cell.lights[1], region);
+                    vertex(coord + ( sx + sy + axisZ) * s, w, h, cell.lights[2], region);
+                    vertex(coord + (-sx + sy + axisZ) * s, 0, h, cell.lights[3], region);
+                    index(0, 1, 2, 0, 2, 3);
+                    i += w;
+                }
+            }
+        }
+    }
+}
+
 bool BlocksRenderer::isOpenForLight(int x, int y, int z) const {
-    blockid_t id = voxelsBuffer->pickBlockId(chunk->x * CHUNK_W + x, 
+    blockid_t id = voxelsBuffer->pickBlockId(snapshot->x * CHUNK_W + x, 
                                              y, 
-                                             chunk->z * CHUNK_D + z);
+                                             snapshot->z * CHUNK_D + z);
     if (id == BLOCK_VOID) {
         return false;
     }
-    const Block& block = *blockDefsCache[id];
-    if (block.lightPassing) {
+    if (meshInfo[id].lightPassing) {
         return true;
     }
     return !id;
@@ -399,8 +630,8 @@ bool BlocksRenderer::isOpenForLight(int x, int y, int z) const {
 
 glm::vec4 BlocksRenderer::pickLight(int x, int y, int z) const {
     if (isOpenForLight(x, y, z)) {
-        light_t light = voxelsBuffer->pickLight(chunk->x * CHUNK_W + x, y, 
-                                                chunk->z * CHUNK_D + z);
+        light_t light = voxelsBuffer->pickLight(snapshot->x * CHUNK_W + x, y, 
+                                                snapshot->z * CHUNK_D + z);
         return glm::vec4(Lightmap::extract(light, 0),
                          Lightmap::extract(light, 1),
                          Lightmap::extract(light, 2),
@@ -433,21 +664,56 @@ glm::vec4 BlocksRenderer::pickSoftLight(
         right, up);
 }
 
+void BlocksRenderer::computeOpenFaces(const voxel* voxels, int begin, int end) {
+    const int pad = voxelBufferPadding;
+    const int w = voxelsBuffer->getW();
+    const int d = voxelsBuffer->getD();
+    const int h = voxelsBuffer->getH();
+    const voxel* padded = voxelsBuffer->getVoxels();
+
+    // padded buffer index offsets of neighbours in FACE_* order
+    const int offsets[6] {-1, 1, -w * d, w * d, -w, w};
+
+    for (int i = begin; i < end; i++) {
+        const voxel& vox = voxels[i];
+        const auto& info = meshInfo[vox.id];
+        if (vox.id == 0 || info.model != BlockModel::block) {
+            openFaces[i] = 0;
+            continue;
+        }
+        int x = i % CHUNK_W;
+        int y = i / (CHUNK_D * CHUNK_W);
+        int z = (i / CHUNK_D) % CHUNK_W;
+        int index = vox_index(x + pad, y, z + pad, w, d);
+
+        ubyte group = info.drawGroup;
+        ubyte faces = 0;
+        for (uint face = 0; face < 6; face++) {
+            if ((face == FACE_MY && y == 0) || (face == FACE_PY && y + 1 >= h)) {
+                continue;
+            }
+            blockid_t id = padded[index + offsets[face]].id;
+            if (id != BLOCK_VOID && meshInfo[id].isOpenFor(group)) {
+                faces |= 1 << face;
+            }
+        }
+        openFaces[i] = faces;
+    }
+}
+
 void BlocksRenderer::render(const voxel* voxels) {
-    int totalBegin = chunk->bottom * (CHUNK_W * CHUNK_D);
-    int totalEnd = chunk->top * (CHUNK_W * CHUNK_D);
+    int totalBegin = snapshot->bottom * (CHUNK_W * CHUNK_D);
+    int totalEnd = snapshot->top * (CHUNK_W * CHUNK_D);
 
     int beginEnds[256][2] {};
     for (int i = totalBegin; i < totalEnd; i++) {
-        const voxel& vox = voxels[i];
-        blockid_t id = vox.id;
-        const auto& def = *blockDefsCache[id];
-    
-        if (beginEnds[def.drawGroup][0] == 0) {
-            beginEnds[def.drawGroup][0] = i+1;
+        ubyte drawGroup = meshInfo[voxels[i].id].drawGroup;
+        if (beginEnds[drawGroup][0] == 0) {
+            beginEnds[drawGroup][0] = i+1;
         }
-        beginEnds[def.drawGroup][1] = i;
+        beginEnds[drawGroup][1] = i;
     }
+    computeOpenFaces(voxels, totalBegin, totalEnd);
     for (const auto drawGroup : *content.drawGroups) {
         int begin = beginEnds[drawGroup][0];
         if (begin == 0) {
@@ -458,25 +724,23 @@ void BlocksRenderer::render(const voxel* voxels) {
             const voxel& vox = voxels[i];
             blockid_t id = vox.id;
             blockstate state = vox.state;
-            const auto& def = *blockDefsCache[id];
-            if (id == 0 || def.drawGroup != drawGroup || state.segment) {
+            const auto& info = meshInfo[id];
+            if (id == 0 || info.drawGroup != drawGroup || state.segment ||
+                isGreedyMeshable(info)) {
                 continue;
             }
-            const UVRegion texfaces[6] {
-                cache.getRegion(id, 0), 
-                cache.getRegion(id, 1),
-                cache.getRegion(id, 2), 
-                cache.getRegion(id, 3),
-                cache.getRegion(id, 4), 
-                cache.getRegion(id, 5)
-            };
+            const auto& texfaces = info.textureFaces;
             int x = i % CHUNK_W;
             int y = i / (CHUNK_D * CHUNK_W);
             int z = (i / CHUNK_D) % CHUNK_W;
-            switch (def.model) {
+            const auto& def = *blockDefsCache[id];
+            switch (info.model) {
                 case BlockModel::block:
-                    blockCube({x, y, z}, texfaces, def, vox.state, !def.shadeless,
-                              def.ambientOcclusion);
+                    if (openFaces[i] == 0) {
+                        break;
+                    }
+                    blockCube({x, y, z}, texfaces, def, vox.state, openFaces[i],
+                              !info.shadeless, info.ambientOcclusion);
                     break;
                 case BlockModel::xsprite: {
                     blockXSprite(x, y, z, glm::vec3(1.0f), 
@@ -485,12 +749,12 @@ void BlocksRenderer::render(const voxel* voxels) {
                 }
                 case BlockModel::aabb: {
                     blockAABB({x, y, z}, texfaces, &def, vox.state.rotation, 
-                              !def.shadeless, def.ambientOcclusion);
+                              !info.shadeless, info.ambientOcclusion);
                     break;
                 }
                 case BlockModel::custom: {
                     blockCustomModel({x, y, z}, &def, vox.state.rotation, 
-                                     !def.shadeless, def.ambientOcclusion);
+                                     !info.shadeless, info.ambientOcclusion);
                     break;
                 }
                 default:
@@ -500,48 +764,91 @@ void BlocksRenderer::render(const voxel* voxels) {
                 return;
             }
         }
+        if (greedyMeshing) {
+            greedyCubes(voxels, drawGroup, begin - 1, end);
+            if (overflow) {
+                return;
+            }
+        }
+    }
+}
+
+void BlocksRenderer::takeSnapshot(
+    const Chunk& chunk, const Chunks& chunks, ChunkSnapshot& dst
+) const {
+    PROFILE_SCOPE("meshing.snapshot");
+    if (dst.voxels == nullptr) {
+        dst.voxels = std::make_unique<voxel[]>(CHUNK_VOL);
     }
+    if (dst.volume == nullptr) {
+        dst.volume = std::make_unique<VoxelsVolume>(
+            CHUNK_W + voxelBufferPadding * 2,
+            CHUNK_H,
+            CHUNK_D + voxelBufferPadding * 2
+        );
+    }
+    dst.x = chunk.x;
+    dst.z = chunk.z;
+    dst.greedyMeshing = settings.graphics.greedyMeshing.get();
+    dst.bottom = chunk.bottom;
+    dst.top = chunk.top;
+
+    int begin = chunk.bottom * (CHUNK_W * CHUNK_D);
+    int end = chunk.top * (CHUNK_W * CHUNK_D);
+    std::copy(chunk.voxels + begin, chunk.voxels + end, dst.voxels.get() + begin);
+
+    dst.volume->setPosition(
+        chunk.x * CHUNK_W - voxelBufferPadding, 0,
+        chunk.z * CHUNK_D - voxelBufferPadding);
+    chunks.getVoxels(dst.volume.get(), settings.graphics.backlight.get());
 }
 
-void BlocksRenderer::build(const Chunk* chunk, const Chunks* chunks) {
-    this->chunk = chunk;
-    voxelsBuffer->setPosition(
-        chunk->x * CHUNK_W - voxelBufferPadding, 0,
-        chunk->z * CHUNK_D - voxelBufferPadding);
-    chunks->getVoxels(voxelsBuffer.get(), settings.graphics.backlight.get());
+void BlocksRenderer::build(const ChunkSnapshot& snapshot) {
+    PROFILE_SCOPE("meshing.build");
+    this->snapshot = &snapshot;
+    voxelsBuffer = snapshot.volume.get();
+    greedyMeshing = snapshot.greedyMeshing;
+    uint requiredVertexSize = greedyMeshing ? GREEDY_VERTEX_SIZE : VERTEX_SIZE;
+    if (vertexSize != requiredVertexSize) {
+        vertexSize = requiredVertexSize;
+        vertexBuffer = std::make_unique<float[]>(capacity * vertexSize);
+    }
     overflow = false;
     vertexOffset = 0;
     indexOffset = indexSize = 0;
     if (voxelsBuffer->pickBlockId(
-        chunk->x * CHUNK_W, 0, chunk->z * CHUNK_D
+        snapshot.x * CHUNK_W, 0, snapshot.z * CHUNK_D
     ) == BLOCK_VOID) {
         cancelled = true;
         return;
     }
     cancelled = false;
-    const voxel* voxels = chunk->voxels;
-    render(voxels);
+    render(snapshot.voxels.get());
+}
+
+const vattr* BlocksRenderer::getVertexAttrs() const {
+    return greedyMeshing ? GREEDY_VERTEX_ATTRS : VERTEX_ATTRS;
 }
 
 MeshData BlocksRenderer::createMesh() {
-    const vattr attrs[]{ {3}, {2}, {1}, {0} };
+    const vattr* attrs = getVertexAttrs();
+    size_t attrsCount = greedyMeshing ? std::size(GREEDY_VERTEX_ATTRS)
+                                      : std::size(VERTEX_ATTRS);
     return MeshData(
         util::Buffer<float>(vertexBuffer.get(), vertexOffset), 
         util::Buffer<int>(indexBuffer.get(), indexSize),
-        util::Buffer<vattr>({{3}, {2}, {1}, {0}})
+        util::Buffer<vattr>(attrs, attrsCount)
     );
 }
 
 std::shared_ptr<Mesh> BlocksRenderer::render(const Chunk* chunk, const Chunks* chunks) {
-    build(chunk, chunks);
+    takeSnapshot(*chunk, *chunks, ownSnapshot);
+    build(ownSnapshot);
 
-    const vattr attrs[]{ {3}, {2}, {1}, {0} };
-    size_t vcount = vertexOffset / BlocksRenderer::VERTEX_SIZE;
+    size_t vcount = vertexOffset / vertexSize;
     return std::make_shared<Mesh>(
-        vertexBuffer.get(), vcount, indexBuffer.get(), indexSize, attrs
+        vertexBuffer.get(), vcount, indexBuffer.get(), indexSize,
+        getVertexAttrs()
     );
 }
 
-VoxelsVolume* BlocksRenderer::getVoxelsBuffer() const {
-    return voxelsBuffer.get();
-}
@@ -10,6 +10,7 @@
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
 #include "voxels/VoxelsVolume.hpp"
+#include "frontend/ContentGfxCache.hpp"
 #include "graphics/core/MeshData.hpp"
 #include "maths/util.hpp"
 
@@ -24,28 +25,62 @@ class ContentGfxCache;
 struct EngineSettings;
 struct UVRegion;
 
+/// @brief Immutable copy of chunk data required to build the chunk mesh.
+/// Taken in the main thread, so mesh may be built in any thread without
+/// access to live chunks
+struct ChunkSnapshot {
+    int x = 0;
+    int z = 0;
+    int bottom = 0;
+    int top = 0;
+    /// @brief Chunk voxels (only range between bottom and top is copied)
+    std::unique_ptr<voxel[]> voxels;
+    /// @brief Padded voxels and lights of the chunk and its neighbours
+    std::unique_ptr<VoxelsVolume> volume;
+    /// @brief Greedy meshing setting captured on the main thread
+    bool greedyMeshing = false;
+};
+
 class BlocksRenderer {
     static const glm::vec3 SUN_VECTOR;
     static const uint VERTEX_SIZE;
+    /// @brief Vertex size with extra texture region attribute used by
+    /// greedy meshing to repeat atlas sprites over merged faces
+    static const uint GREEDY_VERTEX_SIZE;
     const Content& content;
     std::unique_ptr<float[]> vertexBuffer;
     std::unique_ptr<int[]> indexBuffer;
+    uint vertexSize = VERTEX_SIZE;
     size_t vertexOffset;
     size_t indexOffset, indexSize;
     size_t capacity;
     int voxelBufferPadding = 2;
     bool overflow = false;
     bool cancelled = false;
-    const Chunk* chunk = nullptr;
-    std::unique_ptr<VoxelsVolume> voxelsBuffer;
+    bool greedyMeshing = false;
+    /// @brief Snapshot of the chunk being built
+    const ChunkSnapshot* snapshot = nullptr;
+    const VoxelsVolume* voxelsBuffer = nullptr;
+    /// @brief Snapshot used by render(...) in the calling thread
+    ChunkSnapshot ownSnapshot;
+    /// @brief Visible faces bitmask per chunk voxel (bit index is FACE_*)
+    std::unique_ptr<ubyte[]> openFaces;
 
     const Block* const* blockDefsCache;
+    const BlockMeshInfo* meshInfo;
     const ContentGfxCache& cache;
     const EngineSettings& settings;
     
     util::PseudoRandom randomizer;
 
     void vertex(const glm::vec3& coord, float u, float v, const glm::vec4& light);
+    void vertex(
+        const glm::vec3& coord,
+        float u,
+        float v,
+        uint32_t light,
+        const UVRegion& region
+    );
     void index(int a, int b, int c, int d, int e, int f);
 
     void vertexAO(
@@ -87,6 +122,7 @@ class BlocksRenderer {
         const UVRegion(&faces)[6], 
         const Block& block, 
         blockstate states, 
+        ubyte openFaces,
         bool lights,
         bool ao
     );
@@ -113,22 +149,35 @@ class BlocksRenderer {
         bool ao
     );
 
+    /// @brief Render faces of full-cube blocks of the draw group merging
+    /// coplanar faces with the same block, texture and lights
+    void greedyCubes(const voxel* voxels, ubyte group, int begin, int end);
+
+    /// @brief Check if the block is rendered by greedyCubes
+    inline bool isGreedyMeshable(const BlockMeshInfo& info) const {
+        return greedyMeshing && info.model == BlockModel::block &&
+               !info.rotatable && !info.extended;
+    }
+
     bool isOpenForLight(int x, int y, int z) const;
 
+    /// @brief Fill openFaces bitmasks for full-cube blocks in the given
+    /// range of chunk voxel indices using the padded voxels buffer
+    void computeOpenFaces(const voxel* voxels, int begin, int end);
 
-    // Does block allow to see other blocks sides (is it transparent)
-    inline bool isOpen(const glm::ivec3& pos, ubyte group) const {
-        auto id = voxelsBuffer->pickBlockId(
-            chunk->x * CHUNK_W + pos.x, pos.y, chunk->z * CHUNK_D + pos.z
-        );
-        if (id == BLOCK_VOID) {
-            return false;
-        }
-        const auto& block = *blockDefsCache[id];
-        if ((block.drawGroup != group && block.lightPassing) || !block.rt.solid) {
-            return true;
+    /// @brief Check if block face in the given direction is visible
+    /// @param faces openFaces bitmask of the block
+    /// @param dir axis-aligned unit vector
+    static inline bool isOpen(ubyte faces, const glm::ivec3& dir) {
+        uint face;
+        if (dir.x) {
+            face = dir.x > 0 ? FACE_PX : FACE_MX;
+        } else if (dir.y) {
+            face = dir.y > 0 ? FACE_PY : FACE_MY;
+        } else {
+            face = dir.z > 0 ? FACE_PZ : FACE_MZ;
         }
-        return !id;
+        return faces & (1 << face);
     }
 
     glm::vec4 pickLight(int x, int y, int z) const;
@@ -145,10 +194,23 @@ public:
     );
     virtual ~BlocksRenderer();
 
-    void build(const Chunk* chunk, const Chunks* chunks);
+    /// @brief Copy chunk data required to build the mesh.
+    /// Must be called in the thread owning chunks
+    /// @param chunk target chunk
+    /// @param chunks chunks matrix used to get neighbour voxels and lights
+    /// @param dst destination snapshot (buffers are allocated if missing)
+    void takeSnapshot(
+        const Chunk& chunk, const Chunks& chunks, ChunkSnapshot& dst
+    ) const;
+
+    /// @brief Build mesh data using chunk snapshot only, so it's safe to
+    /// call from worker threads
+    void build(const ChunkSnapshot& snapshot);
+
+    /// @brief Take snapshot and build mesh in the calling thread
     std::shared_ptr<Mesh> render(const Chunk* chunk, const Chunks* chunks);
     MeshData createMesh();
-    VoxelsVolume* getVoxelsBuffer() const;
+    const vattr* getVertexAttrs() const;
 
     bool isCancelled() const {
         return cancelled;
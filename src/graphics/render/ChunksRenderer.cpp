@@ -1,6 +1,7 @@
 #include "ChunksRenderer.hpp"
 #include "BlocksRenderer.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "assets/Assets.hpp"
 #include "graphics/core/Mesh.hpp"
 #include "graphics/core/Shader.hpp"
@@ -22,28 +23,28 @@ static debug::Logger logger("chunks-render");
 
 size_t ChunksRenderer::visibleChunks = 0;
 
-class RendererWorker : public util::Worker<std::shared_ptr<Chunk>, RendererResult> {
-    const Level& level;
+class RendererWorker : public util::Worker<RendererJob, RendererResult> {
     BlocksRenderer renderer;
 public:
     RendererWorker(
         const Level& level, 
         const ContentGfxCache& cache,
         const EngineSettings& settings
-    ) : level(level), 
-        renderer(settings.graphics.chunkMaxVertices.get(),
+    ) : renderer(settings.graphics.chunkMaxVertices.get(),
                  *level.content, cache, settings)
     {}
 
-    RendererResult operator()(const std::shared_ptr<Chunk>& chunk) override {
-        renderer.build(chunk.get(), level.chunks.get());
+    RendererResult operator()(const RendererJob& job) override {
+        const auto& snapshot = *job.snapshot;
+        glm::ivec2 key(snapshot.x, snapshot.z);
+        renderer.build(snapshot);
         if (renderer.isCancelled()) {
             return RendererResult {
-                glm::ivec2(chunk->x, chunk->z), true, MeshData()};
+                key, job.chunk, true, MeshData(), job.snapshot};
         }
         auto meshData = renderer.createMesh();
         return RendererResult {
-            glm::ivec2(chunk->x, chunk->z), false, std::move(meshData)};
+            key, job.chunk, false, std::move(meshData), job.snapshot};
     }
 };
 
@@ -61,13 +62,25 @@ ChunksRenderer::ChunksRenderer(
         "chunks-render-pool",
         [&](){return std::make_shared<RendererWorker>(*level, cache, settings);}, 
         [&](RendererResult& result){
-            if (!result.cancelled) {
-                meshes[result.key] = std::make_shared<Mesh>(result.meshData);
-            }
             inwork.erase(result.key);
+            releaseSnapshot(std::move(result.snapshot));
+            if (result.cancelled) {
+                return;
+            }
+            // skip meshes of chunks unloaded or replaced while in work
+            auto chunk = result.chunk.lock();
+            if (chunk == nullptr || 
+                this->level.chunks->getChunk(result.key.x, result.key.y) !=
+                    chunk.get()) {
+                return;
+            }
+            meshes[result.key] = std::make_shared<Mesh>(result.meshData);
         }, settings.graphics.chunkMaxRenderers.get())
 {
     threadPool.setStopOnFail(false);
+    // visible chunks meshes are waited by the frame
+    threadPool.setPriority(util::JobPriority::HIGH);
+    maxJobsInWork = threadPool.getWorkersCount() * 4;
     renderer = std::make_unique<BlocksRenderer>(
         settings.graphics.chunkMaxVertices.get(), 
         *level->content, cache, settings
@@ -79,23 +92,127 @@ ChunksRenderer::~ChunksRenderer() {
 }
 
 std::shared_ptr<Mesh> ChunksRenderer::render(const std::shared_ptr<Chunk>& chunk, bool important) {
-    chunk->flags.modified = false;
+    glm::ivec2 key(chunk->x, chunk->z);
     if (important) {
+        // queued job snapshot is outdated now
+        cancelJob(key);
+        chunk->flags.modified = false;
         auto mesh = renderer->render(chunk.get(), level.chunks.get());
-        meshes[glm::ivec2(chunk->x, chunk->z)] = mesh;
+        meshes[key] = mesh;
         return mesh;
     }
-    glm::ivec2 key(chunk->x, chunk->z);
     if (inwork.find(key) != inwork.end()) {
+        // chunk modified again while its job is still in the queue:
+        // replace the job with a new snapshot
+        if (!cancelJob(key)) {
+            // keep modified flag to rebuild mesh again after the current
+            // job finished, all changes made until then are coalesced
+            return nullptr;
+        }
+    }
+    // half of the slots is reserved for chunks visible to the camera
+    size_t limit = maxJobsInWork;
+    if (!isVisible(chunk->x, chunk->z, chunk->bottom, chunk->top)) {
+        limit /= 2;
+    }
+    if (inwork.size() >= limit) {
         return nullptr;
     }
+    chunk->flags.modified = false;
     inwork[key] = true;
-    threadPool.enqueueJob(chunk);
+
+    auto snapshot = acquireSnapshot();
+    renderer->takeSnapshot(*chunk, *level.chunks, *snapshot);
+    threadPool.enqueueJob(RendererJob {key, chunk, std::move(snapshot)});
+    jobsUnordered = true;
     return nullptr;
 }
 
+bool ChunksRenderer::cancelJob(const glm::ivec2& key) {
+    if (inwork.find(key) == inwork.end()) {
+        return false;
+    }
+    size_t removed = threadPool.removeJobs(
+        [key](const RendererJob& job) { return job.key == key; },
+        [this](RendererJob& job) { releaseSnapshot(std::move(job.snapshot)); }
+    );
+    if (removed) {
+        inwork.erase(key);
+        return true;
+    }
+    return false;
+}
+
+std::shared_ptr<ChunkSnapshot> ChunksRenderer::acquireSnapshot() {
+    if (freeSnapshots.empty()) {
+        return std::make_shared<ChunkSnapshot>();
+    }
+    auto snapshot = std::move(freeSnapshots.back());
+    freeSnapshots.pop_back();
+    return snapshot;
+}
+
+void ChunksRenderer::releaseSnapshot(std::shared_ptr<ChunkSnapshot> snapshot) {
+    if (snapshot && freeSnapshots.size() < maxJobsInWork) {
+        freeSnapshots.push_back(std::move(snapshot));
+    }
+}
+
+bool ChunksRenderer::isVisible(int x, int z, int bottom, int top) const {
+    if (!culling) {
+        return true;
+    }
+    glm::vec3 min(x * CHUNK_W, bottom, z * CHUNK_D);
+    glm::vec3 max(x * CHUNK_W + CHUNK_W, top, z * CHUNK_D + CHUNK_D);
+    return frustum.isBoxVisible(min, max);
+}
+
+float ChunksRenderer::getJobPriority(const RendererJob& job) const {
+    const auto& snapshot = *job.snapshot;
+    float dx = (job.key.x + 0.5f) * CHUNK_W - cameraPosition.x;
+    float dz = (job.key.y + 0.5f) * CHUNK_D - cameraPosition.z;
+    float priority = dx * dx + dz * dz;
+    if (!isVisible(job.key.x, job.key.y, snapshot.bottom, snapshot.top)) {
+        // invisible chunks are handled as if they were 4 times further
+        priority *= 16.0f;
+    }
+    return priority;
+}
+
+void ChunksRenderer::prioritizeJobs(const Camera& camera) {
+    bool cameraMoved = 
+        glm::distance(camera.position, cameraPosition) >= 1.0f ||
+        glm::dot(camera.front, cameraFront) < 0.99f;
+    if (!cameraMoved && !jobsUnordered) {
+        return;
+    }
+    if (cameraMoved) {
+        cameraPosition = camera.position;
+        cameraFront = camera.front;
+
+        const auto& chunks = *level.chunks;
+        threadPool.removeJobs(
+            [&chunks](const RendererJob& job) {
+                auto chunk = job.chunk.lock();
+                return chunk == nullptr || 
+                       chunks.getChunk(job.key.x, job.key.y) != chunk.get();
+            },
+            [this](RendererJob& job) {
+                inwork.erase(job.key);
+                releaseSnapshot(std::move(job.snapshot));
+            }
+        );
+    }
+    threadPool.sortJobs([this](const RendererJob& job) {
+        return getJobPriority(job);
+    });
+    jobsUnordered = false;
+}
+
 void ChunksRenderer::unload(const Chunk* chunk) {
-    auto found = meshes.find(glm::ivec2(chunk->x, chunk->z));
+    glm::ivec2 key(chunk->x, chunk->z);
+    cancelJob(key);
+    auto found = meshes.find(key);
     if (found != meshes.end()) {
         meshes.erase(found);
     }
@@ -119,6 +236,7 @@ std::shared_ptr<Mesh> ChunksRenderer::getOrRender(const std::shared_ptr<Chunk>&
 }
 
 void ChunksRenderer::update() {
+    PROFILE_SCOPE("meshing.results");
     threadPool.update();
 }
 
@@ -167,8 +285,6 @@ void ChunksRenderer::drawChunks(
     atlas.getTexture()->bind();
     update();
 
-    // [warning] this whole method is not thread-safe for chunks
-
     int chunksWidth = chunks.getWidth();
     int chunksOffsetX = chunks.getOffsetX();
     int chunksOffsetY = chunks.getOffsetY();
@@ -188,7 +304,7 @@ void ChunksRenderer::drawChunks(
     }
     util::insertion_sort(indices.begin(), indices.end());
 
-    bool culling = settings.graphics.frustumCulling.get();
+    culling = settings.graphics.frustumCulling.get();
 
     visibleChunks = 0;
     //if (GLEW_ARB_multi_draw_indirect && false) {
@@ -198,4 +314,5 @@ void ChunksRenderer::drawChunks(
             visibleChunks += drawChunk(indices[i].index, camera, shader, culling);
         }
     //}
+    prioritizeJobs(camera);
 }
@@ -21,6 +21,7 @@ class Assets;
 class Frustum;
 class BlocksRenderer;
 class ContentGfxCache;
+struct ChunkSnapshot;
 struct EngineSettings;
 
 struct ChunksSortEntry {
@@ -32,10 +33,21 @@ struct ChunksSortEntry {
     }
 };
 
+/// @brief Mesh building job. Worker uses the snapshot only, live chunk
+/// is never accessed outside of the main thread
+struct RendererJob {
+    glm::ivec2 key;
+    std::weak_ptr<Chunk> chunk;
+    std::shared_ptr<ChunkSnapshot> snapshot;
+};
+
 struct RendererResult {
     glm::ivec2 key;
+    std::weak_ptr<Chunk> chunk;
     bool cancelled;
     MeshData meshData;
+    /// @brief Job snapshot returned to be reused
+    std::shared_ptr<ChunkSnapshot> snapshot;
 };
 
 class ChunksRenderer {
@@ -48,11 +60,32 @@ class ChunksRenderer {
     std::unordered_map<glm::ivec2, std::shared_ptr<Mesh>> meshes;
     std::unordered_map<glm::ivec2, bool> inwork;
     std::vector<ChunksSortEntry> indices;
-    util::ThreadPool<std::shared_ptr<Chunk>, RendererResult> threadPool;
+    util::ThreadPool<RendererJob, RendererResult> threadPool;
+    /// @brief Max number of jobs in work (limits snapshots memory usage)
+    size_t maxJobsInWork;
+    /// @brief Snapshots of finished jobs, reused to not reallocate buffers
+    std::vector<std::shared_ptr<ChunkSnapshot>> freeSnapshots;
+    /// @brief Camera position and direction used for jobs priority
+    glm::vec3 cameraPosition {};
+    glm::vec3 cameraFront {};
+    bool culling = false;
+    /// @brief Jobs queue needs to be reordered
+    bool jobsUnordered = false;
 
     bool drawChunk(
         size_t index, const Camera& camera, Shader& shader, bool culling
     );
+    bool isVisible(int x, int z, int bottom, int top) const;
+    /// @brief Get mesh job priority. Jobs with lesser value are done first
+    float getJobPriority(const RendererJob& job) const;
+    /// @brief Cancel queued jobs of unloaded chunks and reorder the rest by
+    /// distance to camera and visibility
+    void prioritizeJobs(const Camera& camera);
+    /// @brief Cancel queued (not started) mesh job of the chunk
+    /// @return true if job was removed from the queue
+    bool cancelJob(const glm::ivec2& key);
+    std::shared_ptr<ChunkSnapshot> acquireSnapshot();
+    void releaseSnapshot(std::shared_ptr<ChunkSnapshot> snapshot);
 public:
     ChunksRenderer(
         const Level* level,
@@ -26,8 +26,12 @@ void LightSolver::add(int x, int y, int z, int emission) {
 
     addqueue.push(lightentry {x, y, z, ubyte(emission)});
 
-    chunk->flags.modified = true;
-    chunk->lightmap.set(x-chunk->x*CHUNK_W, y, z-chunk->z*CHUNK_D, channel, emission);
+    int lx = x - chunk->x * CHUNK_W;
+    int lz = z - chunk->z * CHUNK_D;
+    if (emission != light) {
+        chunks->markModified(*chunk, lx, lz);
+    }
+    chunk->lightmap.set(lx, y, lz, channel, emission);
 }
 
 void LightSolver::add(int x, int y, int z) {
@@ -45,7 +49,11 @@ void LightSolver::remove(int x, int y, int z) {
         return;
     }
     remqueue.push(lightentry {x, y, z, light});
-    chunk->lightmap.set(x-chunk->x*CHUNK_W, y, z-chunk->z*CHUNK_D, channel, 0);
+
+    int lx = x - chunk->x * CHUNK_W;
+    int lz = z - chunk->z * CHUNK_D;
+    chunks->markModified(*chunk, lx, lz);
+    chunk->lightmap.set(lx, y, lz, channel, 0);
 }
 
 void LightSolver::solve(){
@@ -72,10 +80,10 @@ void LightSolver::solve(){
             if (chunk) {
                 int lx = x - chunk->x * CHUNK_W;
                 int lz = z - chunk->z * CHUNK_D;
-                chunk->flags.modified = true;
 
                 ubyte light = chunk->lightmap.get(lx,y,lz, channel);
                 if (light != 0 && light == entry.light-1){
+                    chunks->markModified(*chunk, lx, lz);
                     voxel* vox = chunks->get(x, y, z);
                     if (vox && vox->id != 0) {
                         const Block* block = blockDefs[vox->id];
@@ -109,12 +117,12 @@ void LightSolver::solve(){
             if (chunk) {
                 int lx = x - chunk->x * CHUNK_W;
                 int lz = z - chunk->z * CHUNK_D;
-                chunk->flags.modified = true;
 
                 ubyte light = chunk->lightmap.get(lx, y, lz, channel);
                 voxel& v = chunk->voxels[vox_index(lx, y, lz)];
                 const Block* block = blockDefs[v.id];
                 if (block->lightPassing && light+2 <= entry.light){
+                    chunks->markModified(*chunk, lx, lz);
                     chunk->lightmap.set(
                         x-chunk->x*CHUNK_W, y, z-chunk->z*CHUNK_D, 
                         channel, 
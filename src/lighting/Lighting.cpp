@@ -7,8 +7,10 @@
 #include "voxels/voxel.hpp"
 #include "voxels/Block.hpp"
 #include "constants.hpp"
+#include "debug/Profiler.hpp"
 #include "util/timeutil.hpp"
 
+#include <algorithm>
 #include <memory>
 
 Lighting::Lighting(const Content* content, Chunks* chunks) 
@@ -24,8 +26,8 @@ Lighting::~Lighting() = default;
 
 void Lighting::clear(){
     const auto& chunks = this->chunks->getChunks();
-    for (size_t index = 0; index < chunks.size(); index++){
-        auto chunk = chunks[index];
+    for (size_t index = 0; index < chunks.area(); index++){
+        const auto& chunk = chunks[index];
         if (chunk == nullptr)
             continue;
         Lightmap& lightmap = chunk->lightmap;
@@ -60,6 +62,7 @@ void Lighting::prebuildSkyLight(Chunk* chunk, const ContentIndices* indices){
 }
 
 void Lighting::buildSkyLight(int cx, int cz){
+    PROFILE_SCOPE("lighting.sky");
     const auto blockDefs = content->getIndices()->blocks.getDefs();
 
     Chunk* chunk = chunks->getChunk(cx, cz);
@@ -87,6 +90,7 @@ void Lighting::buildSkyLight(int cx, int cz){
 }
 
 void Lighting::onChunkLoaded(int cx, int cz, bool expand){
+    PROFILE_SCOPE("lighting.chunk");
     LightSolver* solverR = this->solverR.get();
     LightSolver* solverG = this->solverG.get();
     LightSolver* solverB = this->solverB.get();
@@ -150,6 +154,7 @@ void Lighting::onChunkLoaded(int cx, int cz, bool expand){
 }
 
 void Lighting::onBlockSet(int x, int y, int z, blockid_t id){
+    PROFILE_SCOPE("lighting.block");
     const auto& block = content->getIndices()->blocks.require(id);
     solverR->remove(x,y,z);
     solverG->remove(x,y,z);
@@ -202,3 +207,78 @@ void Lighting::onBlockSet(int x, int y, int z, blockid_t id){
         }
     }
 }
+
+void Lighting::onBlocksSet(const std::vector<glm::ivec3>& positions) {
+    PROFILE_SCOPE("lighting.blocks");
+    const auto& blocks = content->getIndices()->blocks;
+    for (const auto& pos : positions) {
+        int x = pos.x, y = pos.y, z = pos.z;
+        solverR->remove(x, y, z);
+        solverG->remove(x, y, z);
+        solverB->remove(x, y, z);
+
+        const voxel* vox = chunks->get(x, y, z);
+        if (vox == nullptr || vox->id == 0 ||
+            blocks.require(vox->id).skyLightPassing) {
+            continue;
+        }
+        solverS->remove(x, y, z);
+        for (int i = y - 1; i >= 0; i--) {
+            solverS->remove(x, i, z);
+            const voxel* below = chunks->get(x, i - 1, z);
+            if (i == 0 || below == nullptr || below->id != 0) {
+                break;
+            }
+        }
+    }
+    solverR->solve();
+    solverG->solve();
+    solverB->solve();
+    solverS->solve();
+
+    // sky light columns are filled starting from the top blocks
+    std::vector<glm::ivec3> sorted(positions);
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.y > b.y;
+    });
+    for (const auto& pos : sorted) {
+        int x = pos.x, y = pos.y, z = pos.z;
+        const voxel* vox = chunks->get(x, y, z);
+        if (vox == nullptr) {
+            continue;
+        }
+        if (vox->id == 0) {
+            if (chunks->getLight(x, y + 1, z, 3) == 0xF) {
+                for (int i = y; i >= 0; i--) {
+                    const voxel* column = chunks->get(x, i, z);
+                    if (column == nullptr || column->id != 0) {
+                        break;
+                    }
+                    solverS->add(x, i, z, 0xF);
+                }
+            }
+            const glm::ivec3 neighbours[] {
+                {x, y + 1, z}, {x, y - 1, z},
+                {x + 1, y, z}, {x - 1, y, z},
+                {x, y, z + 1}, {x, y, z - 1},
+            };
+            for (const auto& n : neighbours) {
+                solverR->add(n.x, n.y, n.z);
+                solverG->add(n.x, n.y, n.z);
+                solverB->add(n.x, n.y, n.z);
+                solverS->add(n.x, n.y, n.z);
+            }
+            continue;
+        }
+        const auto& block = blocks.require(vox->id);
+        if (block.emission[0] || block.emission[1] || block.emission[2]) {
+            solverR->add(x, y, z, block.emission[0]);
+            solverG->add(x, y, z, block.emission[1]);
+            solverB->add(x, y, z, block.emission[2]);
+        }
+    }
+    solverR->solve();
+    solverG->solve();
+    solverB->solve();
+    solverS->solve();
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+#include <glm/glm.hpp>
+
 #include "typedefs.hpp"
 
 class Content;
@@ -24,5 +27,10 @@ public:
     void onChunkLoaded(int cx, int cz, bool expand);
     void onBlockSet(int x, int y, int z, blockid_t id);
 
+    /// @brief Update lights after many blocks set with a single combined
+    /// removal and addition pass instead of solving each block separately
+    /// @param positions positions of changed blocks (voxels are already set)
+    void onBlocksSet(const std::vector<glm::ivec3>& positions);
+
     static void prebuildSkyLight(Chunk* chunk, const ContentIndices* indices);
 };
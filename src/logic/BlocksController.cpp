@@ -1,6 +1,9 @@
 #include "BlocksController.hpp"
 
+#include <algorithm>
+
 #include "content/Content.hpp"
+#include "debug/Logger.hpp"
 #include "items/Inventories.hpp"
 #include "items/Inventory.hpp"
 #include "lighting/Lighting.hpp"
@@ -14,6 +17,21 @@
 #include "world/Level.hpp"
 #include "world/World.hpp"
 
+static debug::Logger logger("blocks-controller");
+
+/// @brief Sort positions and remove duplicates
+static void sort_unique(std::vector<glm::ivec3>& positions) {
+    auto less = [](const glm::ivec3& a, const glm::ivec3& b) {
+        if (a.y != b.y) return a.y < b.y;
+        if (a.z != b.z) return a.z < b.z;
+        return a.x < b.x;
+    };
+    std::sort(positions.begin(), positions.end(), less);
+    positions.erase(
+        std::unique(positions.begin(), positions.end()), positions.end()
+    );
+}
+
 BlocksController::BlocksController(Level* level, uint padding)
     : level(level),
       chunks(level->chunks.get()),
@@ -25,6 +43,10 @@ BlocksController::BlocksController(Level* level, uint padding)
 }
 
 void BlocksController::updateSides(int x, int y, int z) {
+    if (batchDepth) {
+        batchUpdates.emplace_back(x, y, z);
+        return;
+    }
     updateBlock(x - 1, y, z);
     updateBlock(x + 1, y, z);
     updateBlock(x, y - 1, z);
@@ -40,13 +62,14 @@ void BlocksController::updateSides(int x, int y, int z, int w, int h, int d) {
     const auto& xaxis = rot.axisX;
     const auto& yaxis = rot.axisY;
     const auto& zaxis = rot.axisZ;
+    std::vector<glm::ivec3> positions;
     for (int ly = -1; ly <= h; ly++) {
         for (int lz = -1; lz <= d; lz++) {
             for (int lx = -1; lx <= w; lx++) {
                 if (lx >= 0 && lx < w && ly >= 0 && ly < h && lz >= 0 && lz < d) {
                     continue;
                 }
-                updateBlock(
+                positions.emplace_back(
                     x + lx * xaxis.x + ly * yaxis.x + lz * zaxis.x,
                     y + lx * xaxis.y + ly * yaxis.y + lz * zaxis.y,
                     z + lx * xaxis.z + ly * yaxis.z + lz * zaxis.z
@@ -54,6 +77,97 @@ void BlocksController::updateSides(int x, int y, int z, int w, int h, int d) {
             }
         }
     }
+    if (batchDepth) {
+        batchBlocks.insert(
+            batchBlocks.end(), positions.begin(), positions.end()
+        );
+        return;
+    }
+    for (const auto& pos : positions) {
+        updateBlock(pos.x, pos.y, pos.z);
+    }
+}
+
+void BlocksController::updateSides(const std::vector<glm::ivec3>& positions) {
+    if (batchDepth) {
+        batchUpdates.insert(
+            batchUpdates.end(), positions.begin(), positions.end()
+        );
+        return;
+    }
+    updateNeighbours(positions);
+}
+
+void BlocksController::updateNeighbours(
+    const std::vector<glm::ivec3>& positions,
+    std::vector<glm::ivec3> neighbours
+) {
+    neighbours.reserve(neighbours.size() + positions.size() * 6);
+    for (const auto& pos : positions) {
+        neighbours.emplace_back(pos.x - 1, pos.y, pos.z);
+        neighbours.emplace_back(pos.x + 1, pos.y, pos.z);
+        neighbours.emplace_back(pos.x, pos.y - 1, pos.z);
+        neighbours.emplace_back(pos.x, pos.y + 1, pos.z);
+        neighbours.emplace_back(pos.x, pos.y, pos.z - 1);
+        neighbours.emplace_back(pos.x, pos.y, pos.z + 1);
+    }
+    sort_unique(neighbours);
+    for (const auto& pos : neighbours) {
+        updateBlock(pos.x, pos.y, pos.z);
+    }
+}
+
+void BlocksController::updateLights(int x, int y, int z, blockid_t id) {
+    if (batchDepth) {
+        batchChanged.emplace_back(x, y, z);
+        return;
+    }
+    lighting->onBlockSet(x, y, z, id);
+}
+
+void BlocksController::updateLights(const std::vector<glm::ivec3>& positions) {
+    if (batchDepth) {
+        batchChanged.insert(
+            batchChanged.end(), positions.begin(), positions.end()
+        );
+        return;
+    }
+    lighting->onBlocksSet(positions);
+}
+
+void BlocksController::beginBatch() {
+    batchDepth++;
+}
+
+void BlocksController::endBatch() {
+    if (batchDepth == 0 || --batchDepth > 0) {
+        return;
+    }
+    // changes made by neighbour updates are collected to the next pass
+    batchDepth++;
+    while (!batchChanged.empty() || !batchUpdates.empty() ||
+           !batchBlocks.empty()) {
+        auto changed = std::move(batchChanged);
+        auto updates = std::move(batchUpdates);
+        auto blocks = std::move(batchBlocks);
+        batchChanged.clear();
+        batchUpdates.clear();
+        batchBlocks.clear();
+
+        sort_unique(changed);
+        lighting->onBlocksSet(changed);
+        updateNeighbours(updates, std::move(blocks));
+    }
+    batchDepth--;
+}
+
+void BlocksController::endAllBatches() {
+    if (batchDepth == 0) {
+        return;
+    }
+    logger.warning() << "closing " << batchDepth << " unfinished edit batch(es)";
+    batchDepth = 1;
+    endBatch();
 }
 
 void BlocksController::breakBlock(
@@ -63,7 +177,7 @@ void BlocksController::breakBlock(
         player, glm::ivec3(x, y, z), def, BlockInteraction::destruction
     );
     chunks->set(x, y, z, 0, {});
-    lighting->onBlockSet(x, y, z, 0);
+    updateLights(x, y, z, 0);
     scripting::on_block_broken(player, def, glm::ivec3(x, y, z));
     if (def.rt.extended) {
         updateSides(x, y, z , def.size.x, def.size.y, def.size.z);
@@ -79,7 +193,7 @@ void BlocksController::placeBlock(
         player, glm::ivec3(x, y, z), def, BlockInteraction::placing
     );
     chunks->set(x, y, z, def.rt.id, state);
-    lighting->onBlockSet(x, y, z, def.rt.id);
+    updateLights(x, y, z, def.rt.id);
     scripting::on_block_placed(player, def, glm::ivec3(x, y, z));
     if (def.rt.extended) {
         updateSides(x, y, z , def.size.x, def.size.y, def.size.z);
@@ -114,6 +228,7 @@ void BlocksController::update(float delta) {
     if (worldTickClock.update(delta)) {
         scripting::on_world_tick();
     }
+    endAllBatches();
 }
 
 void BlocksController::onBlocksTick(int tickid, int parts) {
@@ -142,7 +257,12 @@ void BlocksController::randomTick(
             int bz = random.rand() % CHUNK_D;
             const voxel& vox = chunk.voxels[vox_index(bx, by, bz)];
             auto& block = indices->blocks.require(vox.id);
-            if (block.rt.funcsset.randupdate) {
+            if (block.rt.funcsset.randupdatebatch) {
+                auto& coords = randomTickBatches[vox.id];
+                coords.push_back(chunk.x * CHUNK_W + bx);
+                coords.push_back(by);
+                coords.push_back(chunk.z * CHUNK_D + bz);
+            } else if (block.rt.funcsset.randupdate) {
                 scripting::random_update_block(
                     block,
                     glm::ivec3(
@@ -159,6 +279,7 @@ void BlocksController::randomTick(int tickid, int parts) {
     int width = chunks->getWidth();
     int height = chunks->getHeight();
     int segments = 4;
+    randomTickBatches.resize(indices->blocks.count());
 
     for (uint z = padding; z < height - padding; z++) {
         for (uint x = padding; x < width - padding; x++) {
@@ -173,6 +294,32 @@ void BlocksController::randomTick(int tickid, int parts) {
             randomTick(*chunk, segments, indices);
         }
     }
+    for (size_t id = 0; id < randomTickBatches.size(); id++) {
+        auto& coords = randomTickBatches[id];
+        // previous batch handlers may replace sampled blocks
+        filterRandomUpdates(id, coords);
+        if (coords.empty()) {
+            continue;
+        }
+        scripting::random_update_blocks(indices->blocks.require(id), coords);
+        coords.clear();
+    }
+}
+
+void BlocksController::filterRandomUpdates(
+    blockid_t id, std::vector<int32_t>& coords
+) const {
+    size_t count = 0;
+    for (size_t i = 0; i + 2 < coords.size(); i += 3) {
+        const voxel* vox = chunks->get(coords[i], coords[i + 1], coords[i + 2]);
+        if (vox == nullptr || vox->id != id) {
+            continue;
+        }
+        coords[count++] = coords[i];
+        coords[count++] = coords[i + 1];
+        coords[count++] = coords[i + 2];
+    }
+    coords.resize(count);
 }
 
 int64_t BlocksController::createBlockInventory(int x, int y, int z) {
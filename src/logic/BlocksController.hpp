@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 #include <glm/glm.hpp>
 
 #include "maths/fastmaths.hpp"
@@ -33,11 +34,59 @@ class BlocksController {
     uint padding;
     FastRandom random {};
     std::vector<on_block_interaction> blockInteractionCallbacks;
+    /// @brief Random tick hits of blocks handled in batch mode indexed by
+    /// block id (flat coordinates lists)
+    std::vector<std::vector<int32_t>> randomTickBatches;
+    /// @brief Nesting depth of the active edit batch
+    int batchDepth = 0;
+    /// @brief Positions of blocks changed in the edit batch
+    std::vector<glm::ivec3> batchChanged;
+    /// @brief Positions of blocks which neighbours must be updated at the
+    /// edit batch end
+    std::vector<glm::ivec3> batchUpdates;
+    /// @brief Positions of blocks to update at the edit batch end
+    std::vector<glm::ivec3> batchBlocks;
+
+    /// @brief Update neighbours of the positions and the extra blocks,
+    /// each block is updated once
+    void updateNeighbours(
+        const std::vector<glm::ivec3>& positions,
+        std::vector<glm::ivec3> extra = {}
+    );
 public:
     BlocksController(Level* level, uint padding);
 
+    /// @brief Update neighbours of the block (deferred in edit batch)
     void updateSides(int x, int y, int z);
+    /// @brief Update blocks around the extended block
+    /// (deferred in edit batch)
     void updateSides(int x, int y, int z, int w, int h, int d);
+    /// @brief Update neighbours of all changed blocks, each block is
+    /// updated once (deferred in edit batch)
+    /// @param positions changed blocks positions
+    void updateSides(const std::vector<glm::ivec3>& positions);
+
+    /// @brief Update lights after the block set (deferred in edit batch)
+    void updateLights(int x, int y, int z, blockid_t id);
+    /// @brief Update lights after many blocks set with a single solve
+    /// (deferred in edit batch)
+    void updateLights(const std::vector<glm::ivec3>& positions);
+
+    /// @brief Begin edit batch. Lights and neighbours updates of blocks
+    /// changed until the batch end are deferred. Batches may be nested
+    void beginBatch();
+
+    /// @brief End edit batch. The outermost batch end performs a single
+    /// combined lights update for all changed blocks and neighbours
+    /// updates de-duplicated over the changed set
+    void endBatch();
+
+    /// @brief Close all unfinished edit batches (called at the tick end)
+    void endAllBatches();
+
+    bool isBatchActive() const {
+        return batchDepth > 0;
+    }
     void updateBlock(int x, int y, int z);
 
     void breakBlock(Player* player, const Block& def, int x, int y, int z);
@@ -50,6 +99,10 @@ public:
         const Chunk& chunk, int segments, const ContentIndices* indices
     );
     void randomTick(int tickid, int parts);
+    /// @brief Remove random updates hits of blocks replaced since sampling
+    /// @param id block id the hits were sampled for
+    /// @param coords flat coordinates list
+    void filterRandomUpdates(blockid_t id, std::vector<int32_t>& coords) const;
     void onBlocksTick(int tickid, int parts);
     int64_t createBlockInventory(int x, int y, int z);
     void bindInventory(int64_t invid, int x, int y, int z);
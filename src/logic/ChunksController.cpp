@@ -6,10 +6,12 @@
 #include <memory>
 
 #include "content/Content.hpp"
+#include "debug/Profiler.hpp"
 #include "files/WorldFiles.hpp"
 #include "graphics/core/Mesh.hpp"
 #include "lighting/Lighting.hpp"
 #include "maths/voxmaths.hpp"
+#include "settings.hpp"
 #include "util/timeutil.hpp"
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
@@ -21,23 +23,42 @@
 
 const uint MAX_WORK_PER_FRAME = 128;
 const uint MIN_SURROUNDING = 9;
+/// @brief Memory budget of generated chunk prototypes cache
+const size_t PROTOTYPES_CACHE_BUDGET = 32 * 1024 * 1024;
+
+static std::unique_ptr<WorldGenerator> create_generator(Level* level) {
+    auto world = level->getWorld();
+    const auto& wfile = *world->wfile;
+    // generator scripts may change between runs in test mode
+    size_t cacheBudget =
+        wfile.isGeneratorTestMode() ? 0 : PROTOTYPES_CACHE_BUDGET;
+    // evicted prototypes are dropped unless spilling is enabled
+    std::optional<fs::path> cacheFolder;
+    if (level->settings.chunks.prototypesSpill.get()) {
+        cacheFolder = wfile.getFolder() / fs::path("prototypes");
+    }
+    return std::make_unique<WorldGenerator>(
+        level->content->generators.require(world->getGenerator()),
+        level->content,
+        world->getSeed(),
+        cacheBudget,
+        std::move(cacheFolder)
+    );
+}
 
 ChunksController::ChunksController(Level* level, uint padding)
     : level(level),
       chunks(level->chunks.get()),
       lighting(level->lighting.get()),
       padding(padding),
-      generator(std::make_unique<WorldGenerator>(
-          level->content->generators.require(level->getWorld()->getGenerator()),
-          level->content,
-          level->getWorld()->getSeed()
-      )) {}
+      generator(create_generator(level)) {}
 
 ChunksController::~ChunksController() = default;
 
 void ChunksController::update(
     int64_t maxDuration, int loadDistance, int centerX, int centerY
 ) {
+    PROFILE_SCOPE("chunks.update");
     generator->update(centerX, centerY, loadDistance);
 
     int64_t mcstotal = 0;
@@ -105,6 +126,7 @@ bool ChunksController::buildLights(const std::shared_ptr<Chunk>& chunk) {
         }
     }
     if (surrounding == MIN_SURROUNDING) {
+        PROFILE_SCOPE("chunks.lights");
         bool lightsCache = chunk->flags.loadedLights;
         if (!lightsCache) {
             lighting->buildSkyLight(chunk->x, chunk->z);
@@ -117,6 +139,7 @@ bool ChunksController::buildLights(const std::shared_ptr<Chunk>& chunk) {
 }
 
 void ChunksController::createChunk(int x, int z) {
+    PROFILE_SCOPE("chunks.create");
     auto chunk = level->chunksStorage->create(x, z);
     chunks->putChunk(chunk);
     auto& chunkFlags = chunk->flags;
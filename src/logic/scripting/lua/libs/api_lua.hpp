@@ -33,6 +33,7 @@ extern const luaL_Reg mat4lib[];
 extern const luaL_Reg packlib[];
 extern const luaL_Reg particleslib[];
 extern const luaL_Reg playerlib[];
+extern const luaL_Reg profilerlib[];
 extern const luaL_Reg quatlib[];
 extern const luaL_Reg text3dlib[];
 extern const luaL_Reg timelib[];
@@ -1,5 +1,4 @@
 #include "content/Content.hpp"
-#include "lighting/Lighting.hpp"
 #include "logic/BlocksController.hpp"
 #include "logic/LevelController.hpp"
 #include "voxels/Block.hpp"
@@ -9,6 +8,7 @@
 #include "world/Level.hpp"
 #include "maths/voxmaths.hpp"
 #include "data/StructLayout.hpp"
+#include "util/data_io.hpp"
 #include "api_lua.hpp"
 
 using namespace scripting;
@@ -97,7 +97,7 @@ static int l_set(lua::State* L) {
         return 0;
     }
     level->chunks->set(x, y, z, id, int2blockstate(state));
-    level->lighting->onBlockSet(x, y, z, id);
+    blocks->updateLights(x, y, z, id);
     if (!noupdate) {
         blocks->updateSides(x, y, z);
     }
@@ -202,8 +202,14 @@ static int l_set_states(lua::State* L) {
         return 0;
     }
     auto vox = level->chunks->get(x, y, z);
+    auto prevState = vox->state;
     vox->state = int2blockstate(states);
-    chunk->setModifiedAndUnsaved();
+    chunk->flags.unsaved = true;
+    // user bits are not used by the chunk mesh
+    if (prevState.rotation != vox->state.rotation ||
+        prevState.segment != vox->state.segment) {
+        chunk->flags.modified = true;
+    }
     return 0;
 }
 
@@ -259,7 +265,8 @@ static int l_set_user_bits(lua::State* L) {
         }
     }
     vox->state.userbits = (vox->state.userbits & (~mask)) | value;
-    chunk->setModifiedAndUnsaved();
+    // user bits are not used by the chunk mesh, so rebuild is not required
+    chunk->flags.unsaved = true;
     return 0;
 }
 
@@ -484,41 +491,116 @@ static int get_field(
     return 0;
 }
 
-static int l_get_field(lua::State* L) {
+/// @brief Field handle is block id and index of the field in the block
+/// data struct packed into an integer
+static constexpr int FIELD_HANDLE_BITS = 16;
+
+static int l_field_handle(lua::State* L) {
+    auto def = require_block(L);
+    if (def == nullptr || def->dataStruct == nullptr) {
+        return 0;
+    }
+    int index = def->dataStruct->getFieldIndex(lua::require_string(L, 2));
+    if (index == -1) {
+        return 0;
+    }
+    return lua::pushinteger(
+        L, (static_cast<lua::Integer>(def->rt.id) << FIELD_HANDLE_BITS) | index
+    );
+}
+
+/// @brief Get block field by name or by handle at stack index idx.
+/// Handles created for another block are considered as missing fields
+static const data::Field* resolve_field(
+    lua::State* L, int idx, const Block& def
+) {
+    const auto& dataStruct = *def.dataStruct;
+    if (lua::type(L, idx) == LUA_TNUMBER) {
+        auto handle = lua::tointeger(L, idx);
+        if ((handle >> FIELD_HANDLE_BITS) != def.rt.id) {
+            return nullptr;
+        }
+        return dataStruct.getFieldAt(
+            handle & ((1 << FIELD_HANDLE_BITS) - 1)
+        );
+    }
+    return dataStruct.getField(lua::require_string(L, idx));
+}
+
+static void check_field_index(const data::Field& field, size_t index) {
+    if (index >= field.elements) {
+        throw std::out_of_range(
+            "index out of bounds [0, "+std::to_string(field.elements)+"]");
+    }
+}
+
+struct BlockDataRef {
+    Chunk* chunk;
+    size_t voxelIndex;
+    const Block* def;
+};
+
+static BlockDataRef require_block_data(lua::State* L) {
     auto x = lua::tointeger(L, 1);
     auto y = lua::tointeger(L, 2);
     auto z = lua::tointeger(L, 3);
-    auto name = lua::require_string(L, 4);
-    size_t index = 0;
-    if (lua::gettop(L) >= 5) {
-        index = lua::tointeger(L, 5);
-    }
+    const auto& vox = level->chunks->require(x, y, z);
     auto cx = floordiv(x, CHUNK_W);
     auto cz = floordiv(z, CHUNK_D);
     auto chunk = level->chunks->getChunk(cx, cz);
     auto lx = x - cx * CHUNK_W;
-    auto lz = z - cz * CHUNK_W;
-    size_t voxelIndex = vox_index(lx, y, lz);
-
-    const auto& vox = level->chunks->require(x, y, z);
+    auto lz = z - cz * CHUNK_D;
     const auto& def = content->getIndices()->blocks.require(vox.id);
-    if (def.dataStruct == nullptr) {
+    return BlockDataRef {chunk, vox_index(lx, y, lz), &def};
+}
+
+static int l_get_field(lua::State* L) {
+    size_t index = 0;
+    if (lua::gettop(L) >= 5) {
+        index = lua::tointeger(L, 5);
+    }
+    auto [chunk, voxelIndex, def] = require_block_data(L);
+    if (def->dataStruct == nullptr) {
         return 0;
     }
-    const auto& dataStruct = *def.dataStruct;
-    const auto field = dataStruct.getField(name);
+    const auto field = resolve_field(L, 4, *def);
     if (field == nullptr) {
         return 0;
     }
-    if (index >= field->elements) {
-        throw std::out_of_range(
-            "index out of bounds [0, "+std::to_string(field->elements)+"]");
-    }
+    check_field_index(*field, index);
     const ubyte* src = chunk->blocksMetadata.find(voxelIndex);
     if (src == nullptr) {
         return 0;
     }
-    return get_field(L, src, *field, index, dataStruct);
+    return get_field(L, src, *field, index, *def->dataStruct);
+}
+
+/// @brief block.get_fields(x, y, z, fields) -> values...
+/// Returns values of first elements of all listed fields (names or handles)
+/// in one call. Missing fields are nil
+static int l_get_fields(lua::State* L) {
+    if (!lua::istable(L, 4)) {
+        throw std::runtime_error("table expected as fields list");
+    }
+    auto [chunk, voxelIndex, def] = require_block_data(L);
+    int count = lua::objlen(L, 4);
+    if (!lua_checkstack(L, count + 1)) {
+        throw std::runtime_error("too many fields");
+    }
+    const ubyte* src = def->dataStruct
+                           ? chunk->blocksMetadata.find(voxelIndex)
+                           : nullptr;
+    for (int i = 0; i < count; i++) {
+        lua::rawgeti(L, i + 1, 4);
+        const data::Field* field =
+            src ? resolve_field(L, -1, *def) : nullptr;
+        lua::pop(L);
+        if (field == nullptr ||
+            get_field(L, src, *field, 0, *def->dataStruct) == 0) {
+            lua::pushnil(L);
+        }
+    }
+    return count;
 }
 
 static int set_field(
@@ -549,44 +631,184 @@ static int set_field(
     return 0;
 }
 
+static ubyte* require_block_metadata(
+    Chunk& chunk, size_t voxelIndex, const data::StructLayout& dataStruct
+) {
+    ubyte* dst = chunk.blocksMetadata.find(voxelIndex);
+    if (dst == nullptr) {
+        dst = chunk.blocksMetadata.allocate(voxelIndex, dataStruct.size());
+    }
+    chunk.flags.unsaved = true;
+    chunk.flags.blocksData = true;
+    return dst;
+}
+
 static int l_set_field(lua::State* L) {
-    auto x = lua::tointeger(L, 1);
-    auto y = lua::tointeger(L, 2);
-    auto z = lua::tointeger(L, 3);
-    auto name = lua::require_string(L, 4);
     auto value = lua::tovalue(L, 5);
     size_t index = 0;
     if (lua::gettop(L) >= 6) {
         index = lua::tointeger(L, 6);
     }
-    auto vox = level->chunks->get(x, y, z);
-    auto cx = floordiv(x, CHUNK_W);
-    auto cz = floordiv(z, CHUNK_D);
-    auto chunk = level->chunks->getChunk(cx, cz);
-    auto lx = x - cx * CHUNK_W;
-    auto lz = z - cz * CHUNK_W;
-    size_t voxelIndex = vox_index(lx, y, lz);
-
-    const auto& def = content->getIndices()->blocks.require(vox->id);
-    if (def.dataStruct == nullptr) {
+    auto [chunk, voxelIndex, def] = require_block_data(L);
+    if (def->dataStruct == nullptr) {
         return 0;
     }
-    const auto& dataStruct = *def.dataStruct;
-    const auto field = dataStruct.getField(name);
+    const auto& dataStruct = *def->dataStruct;
+    const auto field = resolve_field(L, 4, *def);
     if (field == nullptr) {
         return 0;
     }
-    if (index >= field->elements) {
-        throw std::out_of_range(
-            "index out of bounds [0, "+std::to_string(field->elements)+"]");
+    check_field_index(*field, index);
+    ubyte* dst = require_block_metadata(*chunk, voxelIndex, dataStruct);
+    return set_field(L, dst, *field, index, dataStruct, value);
+}
+
+/// @brief block.set_fields(x, y, z, fields, values)
+/// Writes values to first elements of the listed fields (names or handles)
+/// in one call. Missing fields are skipped
+static int l_set_fields(lua::State* L) {
+    if (!lua::istable(L, 4) || !lua::istable(L, 5)) {
+        throw std::runtime_error("tables expected as fields and values lists");
     }
-    ubyte* dst = chunk->blocksMetadata.find(voxelIndex);
-    if (dst == nullptr) {
-        dst = chunk->blocksMetadata.allocate(voxelIndex, dataStruct.size());
+    auto [chunk, voxelIndex, def] = require_block_data(L);
+    if (def->dataStruct == nullptr) {
+        return 0;
     }
-    chunk->flags.unsaved = true;
-    chunk->flags.blocksData = true;
-    return set_field(L, dst, *field, index, dataStruct, value);
+    const auto& dataStruct = *def->dataStruct;
+    int count = lua::objlen(L, 4);
+    ubyte* dst = nullptr;
+    for (int i = 0; i < count; i++) {
+        lua::rawgeti(L, i + 1, 4);
+        const auto field = resolve_field(L, -1, *def);
+        lua::pop(L);
+        if (field == nullptr) {
+            continue;
+        }
+        lua::rawgeti(L, i + 1, 5);
+        auto value = lua::tovalue(L, -1);
+        lua::pop(L);
+        if (dst == nullptr) {
+            dst = require_block_metadata(*chunk, voxelIndex, dataStruct);
+        }
+        lua::pop(L, set_field(L, dst, *field, 0, dataStruct, value));
+    }
+    return 0;
+}
+
+static constexpr size_t BOX_VOXEL_SIZE = 4;
+static constexpr size_t BOX_LIGHT_SIZE = 2;
+static constexpr int BOX_MAX_VOLUME = 256 * 256 * 256;
+
+static glm::ivec3 require_box_size(lua::State* L, int idx) {
+    glm::ivec3 size(
+        lua::tointeger(L, idx),
+        lua::tointeger(L, idx + 1),
+        lua::tointeger(L, idx + 2)
+    );
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0) {
+        throw std::runtime_error("invalid box size");
+    }
+    if (static_cast<int64_t>(size.x) * size.y * size.z > BOX_MAX_VOLUME) {
+        throw std::runtime_error("box volume is too large");
+    }
+    return size;
+}
+
+/// @brief block.read_box(x, y, z, w, h, d, [lights]) -> Bytearray
+/// Voxels are encoded as big-endian uint16 id and uint16 states.
+/// If lights is true, big-endian uint16 lights of all voxels follow
+static int l_read_box(lua::State* L) {
+    glm::ivec3 start(
+        lua::tointeger(L, 1), lua::tointeger(L, 2), lua::tointeger(L, 3)
+    );
+    auto size = require_box_size(L, 4);
+    bool withLights = lua::toboolean(L, 7);
+
+    size_t volume = size.x * size.y * size.z;
+    std::vector<voxel> voxels(volume);
+    std::vector<light_t> lights(withLights ? volume : 0);
+    level->chunks->getVoxels(
+        start, size, voxels.data(), withLights ? lights.data() : nullptr
+    );
+
+    std::vector<ubyte> bytes(
+        volume * (BOX_VOXEL_SIZE + (withLights ? BOX_LIGHT_SIZE : 0))
+    );
+    ubyte* dst = bytes.data();
+    for (size_t i = 0; i < volume; i++) {
+        dataio::write_int16_big(voxels[i].id, dst, i * BOX_VOXEL_SIZE);
+        dataio::write_int16_big(
+            blockstate2int(voxels[i].state), dst, i * BOX_VOXEL_SIZE + 2
+        );
+    }
+    dst += volume * BOX_VOXEL_SIZE;
+    for (size_t i = 0; i < lights.size(); i++) {
+        dataio::write_int16_big(lights[i], dst, i * BOX_LIGHT_SIZE);
+    }
+    return lua::newuserdata<lua::LuaBytearray>(L, std::move(bytes));
+}
+
+/// @brief block.write_box(x, y, z, w, h, d, data: Bytearray, [noupdate])
+/// Data format is the same as block.read_box output (lights are ignored).
+/// Voxels with id 65535 (void) are skipped
+static int l_write_box(lua::State* L) {
+    glm::ivec3 start(
+        lua::tointeger(L, 1), lua::tointeger(L, 2), lua::tointeger(L, 3)
+    );
+    auto size = require_box_size(L, 4);
+    auto bytearray = lua::touserdata<lua::LuaBytearray>(L, 7);
+    if (bytearray == nullptr) {
+        throw std::runtime_error("Bytearray expected");
+    }
+    bool noupdate = lua::toboolean(L, 8);
+
+    size_t volume = size.x * size.y * size.z;
+    const auto& bytes = bytearray->data();
+    if (bytes.size() < volume * BOX_VOXEL_SIZE) {
+        throw std::runtime_error(
+            "not enough data: " + std::to_string(volume * BOX_VOXEL_SIZE) +
+            " bytes expected"
+        );
+    }
+    size_t blocksCount = content->getIndices()->blocks.count();
+    std::vector<voxel> voxels(volume);
+    const ubyte* src = bytes.data();
+    for (size_t i = 0; i < volume; i++) {
+        auto id = static_cast<blockid_t>(
+            dataio::read_int16_big(src, i * BOX_VOXEL_SIZE)
+        );
+        if (id != BLOCK_VOID && id >= blocksCount) {
+            throw std::runtime_error("invalid block id " + std::to_string(id));
+        }
+        voxels[i].id = id;
+        voxels[i].state = int2blockstate(static_cast<blockstate_t>(
+            dataio::read_int16_big(src, i * BOX_VOXEL_SIZE + 2)
+        ));
+    }
+
+    std::vector<glm::ivec3> changed;
+    level->chunks->setVoxels(start, size, voxels.data(), changed);
+    blocks->updateLights(changed);
+    if (!noupdate) {
+        blocks->updateSides(changed);
+    }
+    return 0;
+}
+
+static int l_batch(lua::State* L) {
+    if (!lua::isfunction(L, 1)) {
+        throw std::runtime_error("function expected");
+    }
+    lua::pushvalue(L, 1);
+    blocks->beginBatch();
+    try {
+        lua::call(L, 0, 0);
+    } catch (...) {
+        blocks->endBatch();
+        throw;
+    }
+    blocks->endBatch();
+    return 0;
 }
 
 const luaL_Reg blocklib[] = {
@@ -624,5 +846,11 @@ const luaL_Reg blocklib[] = {
     {"decompose_state", lua::wrap<l_decompose_state>},
     {"get_field", lua::wrap<l_get_field>},
     {"set_field", lua::wrap<l_set_field>},
+    {"field_handle", lua::wrap<l_field_handle>},
+    {"get_fields", lua::wrap<l_get_fields>},
+    {"set_fields", lua::wrap<l_set_fields>},
+    {"read_box", lua::wrap<l_read_box>},
+    {"write_box", lua::wrap<l_write_box>},
+    {"batch", lua::wrap<l_batch>},
     {NULL, NULL}
 };
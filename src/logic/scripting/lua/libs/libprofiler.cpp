@@ -0,0 +1,74 @@
+#include "api_lua.hpp"
+
+#include "debug/Profiler.hpp"
+#include "engine.hpp"
+#include "files/engine_paths.hpp"
+#include "../lua_engine.hpp"
+#include "../lua_profiler.hpp"
+
+static int l_start(lua::State* L) {
+    int interval = lua::isnoneornil(L, 1) ? 1 : lua::tointeger(L, 1);
+    lua::profiler::start(lua::get_main_state(), interval);
+    return 0;
+}
+
+static int l_stop(lua::State*) {
+    lua::profiler::stop();
+    return 0;
+}
+
+static int l_reset(lua::State*) {
+    lua::profiler::reset();
+    return 0;
+}
+
+static int l_is_active(lua::State* L) {
+    return lua::pushboolean(L, lua::profiler::is_active());
+}
+
+static int l_report(lua::State* L) {
+    size_t limit = lua::isnoneornil(L, 1) ? 20 : lua::tointeger(L, 1);
+    return lua::pushstring(L, lua::profiler::report(limit));
+}
+
+static int l_get_results(lua::State* L) {
+    return lua::pushvalue(L, lua::profiler::to_value());
+}
+
+static int l_get_folded(lua::State* L) {
+    return lua::pushstring(L, lua::profiler::to_folded());
+}
+
+static int l_trace_start(lua::State*) {
+    if (!debug::profiler::is_enabled()) {
+        throw std::runtime_error(
+            "engine is built without instrumentation (VOXELENGINE_PROFILER)"
+        );
+    }
+    debug::profiler::set_tracing(true);
+    return 0;
+}
+
+static int l_trace_stop(lua::State*) {
+    debug::profiler::set_tracing(false);
+    return 0;
+}
+
+static int l_save_trace(lua::State* L) {
+    auto path = scripting::engine->getPaths()->resolve(lua::require_string(L, 1));
+    debug::profiler::save_trace(path);
+    return 0;
+}
+
+const luaL_Reg profilerlib[] = {
+    {"start", lua::wrap<l_start>},
+    {"stop", lua::wrap<l_stop>},
+    {"reset", lua::wrap<l_reset>},
+    {"is_active", lua::wrap<l_is_active>},
+    {"report", lua::wrap<l_report>},
+    {"get_results", lua::wrap<l_get_results>},
+    {"get_folded", lua::wrap<l_get_folded>},
+    {"trace_start", lua::wrap<l_trace_start>},
+    {"trace_stop", lua::wrap<l_trace_stop>},
+    {"save_trace", lua::wrap<l_save_trace>},
+    {NULL, NULL}};
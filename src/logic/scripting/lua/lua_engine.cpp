@@ -9,6 +9,7 @@
 #include "util/stringutil.hpp"
 #include "libs/api_lua.hpp"
 #include "lua_custom_types.hpp"
+#include "lua_profiler.hpp"
 
 static debug::Logger logger("lua-state");
 static lua::State* main_thread = nullptr;
@@ -64,6 +65,7 @@ static void create_libs(State* L, StateType stateType) {
         openlib(L, "audio", audiolib);
         openlib(L, "console", consolelib);
         openlib(L, "player", playerlib);
+        openlib(L, "profiler", profilerlib);
 
         openlib(L, "entities", entitylib);
         openlib(L, "cameras", cameralib);
@@ -116,12 +118,14 @@ void lua::initialize(const EnginePaths& paths) {
 }
 
 void lua::finalize() {
+    profiler::stop();
     lua::close(main_thread);
 }
 
 bool lua::emit_event(
     State* L, const std::string& name, std::function<int(State*)> args
 ) {
+    profiler::Scope scope("event", name);
     getglobal(L, "events");
     getfield(L, "emit");
     pushstring(L, name);
@@ -131,6 +135,40 @@ bool lua::emit_event(
     return result;
 }
 
+int lua::get_event_handlers(State* L, const std::string& name) {
+    if (!getglobal(L, "events")) {
+        return LUA_NOREF;
+    }
+    if (!getfield(L, "handlers")) {
+        pop(L);
+        return LUA_NOREF;
+    }
+    if (!getfield(L, name)) {
+        createtable(L, 0, 0);
+        pushvalue(L, -1);
+        setfield(L, name, -3);
+    }
+    int handlers = luaL_ref(L, LUA_REGISTRYINDEX);
+    pop(L, 2);
+    return handlers;
+}
+
+void lua::release_event_handlers(State* L, int handlers) {
+    luaL_unref(L, LUA_REGISTRYINDEX, handlers);
+}
+
+int lua::push_event_handlers(State* L, int handlers) {
+    if (handlers == LUA_NOREF || handlers == LUA_REFNIL) {
+        return 0;
+    }
+    rawgeti(L, handlers, LUA_REGISTRYINDEX);
+    int count = istable(L, -1) ? objlen(L, -1) : 0;
+    if (count == 0) {
+        pop(L);
+    }
+    return count;
+}
+
 State* lua::get_main_state() {
     return main_thread;
 }
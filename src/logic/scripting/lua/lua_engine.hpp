@@ -23,6 +23,38 @@ namespace lua {
         const std::string& name,
         std::function<int(State*)> args = [](auto*) { return 0; }
     );
+
+    /// @brief Get reference to the event handlers list, creating the list
+    /// if not exists. Handler lists are modified in place by the events
+    /// library, so the reference stays valid until released
+    /// @return registry reference or LUA_NOREF if events library is missing
+    int get_event_handlers(State*, const std::string& name);
+    void release_event_handlers(State*, int handlers);
+
+    /// @brief Push handlers list by reference
+    /// @return number of handlers (nothing is pushed if 0)
+    int push_event_handlers(State*, int handlers);
+
+    /// @brief Call event handlers by reference got with get_event_handlers.
+    /// Same as events.emit, but without event name construction and lookup
+    template <typename ArgsFunc>
+    bool emit_event(State* L, int handlers, const ArgsFunc& args) {
+        int count = push_event_handlers(L, handlers);
+        if (count == 0) {
+            return false;
+        }
+        int top = gettop(L);
+        bool result = false;
+        for (int i = 1; i <= count && !result; i++) {
+            rawgeti(L, i, top);
+            call_nothrow(L, args(L));
+            result = gettop(L) > top && toboolean(L, top + 1);
+            settop(L, top);
+        }
+        pop(L);
+        return result;
+    }
+
     State* get_main_state();
     State* create_state(const EnginePaths& paths, StateType stateType);
     [[nodiscard]] scriptenv create_environment(State* L);
@@ -0,0 +1,179 @@
+#include "lua_profiler.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "debug/Logger.hpp"
+
+static debug::Logger logger("lua-profiler");
+
+using namespace lua;
+
+std::atomic<bool> profiler::detail::active = false;
+
+namespace {
+    struct CallStats {
+        std::string kind;
+        std::string name;
+        uint64_t calls = 0;
+        int64_t totalTime = 0;
+        int64_t maxTime = 0;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, CallStats> calls;
+    std::unordered_map<std::string, uint64_t> samples;
+    State* sampledState = nullptr;
+}
+
+static constexpr int SAMPLE_STACK_DEPTH = 32;
+
+static void sample_callback(void*, State* L, int count, int) {
+    size_t length;
+    const char* stack = luaJIT_profile_dumpstack(
+        L, "lZ;", -SAMPLE_STACK_DEPTH, &length
+    );
+    std::lock_guard lock(mutex);
+    samples[std::string(stack, length)] += count;
+}
+
+void profiler::start(State* L, int interval) {
+    if (is_active()) {
+        return;
+    }
+    interval = std::max(1, interval);
+    sampledState = L;
+    std::string mode = "li" + std::to_string(interval);
+    luaJIT_profile_start(L, mode.c_str(), sample_callback, nullptr);
+    detail::active = true;
+    logger.info() << "started";
+}
+
+void profiler::stop() {
+    if (!is_active()) {
+        return;
+    }
+    detail::active = false;
+    if (sampledState) {
+        luaJIT_profile_stop(sampledState);
+        sampledState = nullptr;
+    }
+    logger.info() << "stopped";
+}
+
+void profiler::reset() {
+    std::lock_guard lock(mutex);
+    calls.clear();
+    samples.clear();
+}
+
+void profiler::add_call(
+    const char* kind,
+    const std::string& name,
+    const char* suffix,
+    int64_t time
+) {
+    std::string key = std::string(kind) + " " + name;
+    if (suffix) {
+        key += ".";
+        key += suffix;
+    }
+    std::lock_guard lock(mutex);
+    auto& stats = calls[key];
+    if (stats.calls == 0) {
+        stats.kind = kind;
+        stats.name = key.substr(stats.kind.length() + 1);
+    }
+    stats.calls++;
+    stats.totalTime += time;
+    stats.maxTime = std::max(stats.maxTime, time);
+}
+
+static std::vector<CallStats> sorted_calls() {
+    std::vector<CallStats> entries;
+    entries.reserve(calls.size());
+    for (const auto& [_, stats] : calls) {
+        entries.push_back(stats);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.totalTime > b.totalTime;
+    });
+    return entries;
+}
+
+static std::vector<std::pair<std::string, uint64_t>> sorted_lines() {
+    // samples are attributed to the innermost frame
+    std::unordered_map<std::string, uint64_t> lines;
+    for (const auto& [stack, count] : samples) {
+        size_t pos = stack.rfind(';');
+        lines[pos == std::string::npos ? stack : stack.substr(pos + 1)] +=
+            count;
+    }
+    std::vector<std::pair<std::string, uint64_t>> entries(
+        lines.begin(), lines.end()
+    );
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second;
+    });
+    return entries;
+}
+
+std::string profiler::report(size_t limit) {
+    std::lock_guard lock(mutex);
+    std::stringstream ss;
+
+    auto entries = sorted_calls();
+    ss << "handlers (total ms, calls, avg us, max us):";
+    for (size_t i = 0; i < std::min(limit, entries.size()); i++) {
+        const auto& stats = entries[i];
+        ss << "\n  " << stats.kind << " " << stats.name << ": "
+           << stats.totalTime / 1000.0 << " ms, " << stats.calls << ", "
+           << stats.totalTime / stats.calls << ", " << stats.maxTime;
+    }
+
+    auto lines = sorted_lines();
+    uint64_t total = 0;
+    for (const auto& [_, count] : lines) {
+        total += count;
+    }
+    ss << "\nsource lines (samples, %):";
+    for (size_t i = 0; i < std::min(limit, lines.size()); i++) {
+        const auto& [line, count] = lines[i];
+        ss << "\n  " << line << ": " << count << ", "
+           << count * 100 / std::max<uint64_t>(1, total) << "%";
+    }
+    return ss.str();
+}
+
+dv::value profiler::to_value() {
+    std::lock_guard lock(mutex);
+    auto root = dv::object();
+    auto& handlersList = root.list("handlers");
+    for (const auto& stats : sorted_calls()) {
+        auto& entry = handlersList.object();
+        entry["kind"] = stats.kind;
+        entry["name"] = stats.name;
+        entry["calls"] = static_cast<dv::integer_t>(stats.calls);
+        entry["total"] = stats.totalTime;
+        entry["max"] = stats.maxTime;
+    }
+    auto& samplesList = root.list("samples");
+    for (const auto& [stack, count] : samples) {
+        auto& entry = samplesList.object();
+        entry["stack"] = stack;
+        entry["count"] = static_cast<dv::integer_t>(count);
+    }
+    return root;
+}
+
+std::string profiler::to_folded() {
+    std::lock_guard lock(mutex);
+    std::stringstream ss;
+    for (const auto& [stack, count] : samples) {
+        ss << stack << " " << count << "\n";
+    }
+    return ss.str();
+}
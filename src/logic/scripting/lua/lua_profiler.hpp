@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <string>
+
+#include "data/dv.hpp"
+#include "lua_commons.hpp"
+#include "util/timeutil.hpp"
+
+/// @brief Scripts profiler. Measures time and calls count of handlers
+/// called by the engine (events, components, generator functions) and
+/// samples Lua source lines of the main state using LuaJIT profiler
+namespace lua::profiler {
+    namespace detail {
+        extern std::atomic<bool> active;
+    }
+
+    /// @brief Start profiling (results of the previous session are kept)
+    /// @param L main Lua state used for source lines sampling
+    /// @param interval sampling interval in milliseconds
+    void start(State* L, int interval = 1);
+
+    void stop();
+
+    /// @brief Clear all collected results
+    void reset();
+
+    inline bool is_active() {
+        return detail::active.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Add handler call time to the results
+    /// @param kind handler kind (event, component, generator, ...)
+    /// @param name handler name
+    /// @param suffix optional name suffix separated with '.'
+    /// @param time call time in microseconds
+    void add_call(
+        const char* kind,
+        const std::string& name,
+        const char* suffix,
+        int64_t time
+    );
+
+    /// @brief Measures handler call time while the profiler is active.
+    /// Clock is not read if inactive. Name is not copied and must outlive
+    /// the scope
+    class Scope {
+        const char* kind;
+        const std::string& name;
+        const char* suffix;
+        std::optional<timeutil::Timer> timer;
+    public:
+        Scope(
+            const char* kind,
+            const std::string& name,
+            const char* suffix = nullptr
+        )
+            : kind(kind), name(name), suffix(suffix) {
+            if (is_active()) {
+                timer.emplace();
+            }
+        }
+
+        ~Scope() {
+            if (timer) {
+                add_call(kind, name, suffix, timer->stop());
+            }
+        }
+    };
+
+    /// @brief Get results as a text report
+    /// @param limit max number of entries in each section
+    std::string report(size_t limit = 20);
+
+    /// @brief Get results as an object:
+    /// {"handlers": [{kind, name, calls, total, max}...],
+    ///  "samples": [{stack, count}...]}. Time is in microseconds
+    dv::value to_value();
+
+    /// @brief Get sampled stacks in folded format used by flame graph tools
+    std::string to_folded();
+}
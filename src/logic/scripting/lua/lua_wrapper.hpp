@@ -32,6 +32,9 @@ namespace lua {
     inline int gettop(lua::State* L) {
         return lua_gettop(L);
     }
+    inline void settop(lua::State* L, int idx) {
+        lua_settop(L, idx);
+    }
     inline size_t objlen(lua::State* L, int idx) {
         return lua_objlen(L, idx);
     }
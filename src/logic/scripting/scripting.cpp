@@ -1,5 +1,6 @@
 #include "scripting.hpp"
 
+#include <array>
 #include <iostream>
 #include <stdexcept>
 
@@ -7,6 +8,7 @@
 #include "content/Content.hpp"
 #include "content/ContentPack.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "engine.hpp"
 #include "files/engine_paths.hpp"
 #include "files/files.hpp"
@@ -17,6 +19,7 @@
 #include "logic/LevelController.hpp"
 #include "lua/lua_engine.hpp"
 #include "lua/lua_custom_types.hpp"
+#include "lua/lua_profiler.hpp"
 #include "maths/Heightmap.hpp"
 #include "objects/Entities.hpp"
 #include "objects/EntityDef.hpp"
@@ -32,6 +35,124 @@ static debug::Logger logger("scripting");
 
 static inline const std::string STDCOMP = "stdcomp";
 
+namespace {
+    enum BlockEvent {
+        BLOCK_EVENT_UPDATE,
+        BLOCK_EVENT_RANDUPDATE,
+        BLOCK_EVENT_RANDUPDATE_BATCH,
+        BLOCK_EVENT_BLOCKSTICK,
+        BLOCK_EVENT_PLACED,
+        BLOCK_EVENT_BROKEN,
+        BLOCK_EVENT_INTERACT,
+        BLOCK_EVENTS_COUNT
+    };
+    const char* BLOCK_EVENT_NAMES[BLOCK_EVENTS_COUNT] {
+        "update",
+        "randupdate",
+        "randupdatebatch",
+        "blockstick",
+        "placed",
+        "broken",
+        "interact"
+    };
+
+    enum WorldBlockEvent {
+        WORLD_EVENT_BLOCKPLACED,
+        WORLD_EVENT_BLOCKBROKEN,
+        WORLD_EVENT_BLOCKINTERACT,
+        WORLD_BLOCK_EVENTS_COUNT
+    };
+    const char* WORLD_BLOCK_EVENT_NAMES[WORLD_BLOCK_EVENTS_COUNT] {
+        "blockplaced", "blockbroken", "blockinteract"
+    };
+}
+
+/// @brief Block event handler lists references indexed by block id,
+/// resolved on world load
+static std::vector<std::array<int, BLOCK_EVENTS_COUNT>> block_events;
+struct PackBlockEvents {
+    std::string packid;
+    std::array<int, WORLD_BLOCK_EVENTS_COUNT> refs;
+};
+
+/// @brief World scripts block event handler lists references of each pack
+static std::vector<PackBlockEvents> world_events;
+
+static void resolve_events() {
+    auto L = lua::get_main_state();
+    const auto& blockDefs = scripting::indices->blocks;
+    block_events.resize(blockDefs.count());
+    for (size_t id = 0; id < blockDefs.count(); id++) {
+        const auto& def = blockDefs.require(id);
+        for (int i = 0; i < BLOCK_EVENTS_COUNT; i++) {
+            block_events[id][i] = lua::get_event_handlers(
+                L, def.name + "." + BLOCK_EVENT_NAMES[i]
+            );
+        }
+    }
+    for (const auto& [packid, pack] : scripting::content->getPacks()) {
+        const auto& funcsset = pack->worldfuncsset;
+        bool flags[WORLD_BLOCK_EVENTS_COUNT] {
+            funcsset.onblockplaced,
+            funcsset.onblockbroken,
+            funcsset.onblockinteract
+        };
+        auto& events = world_events.emplace_back();
+        events.packid = packid;
+        auto& refs = events.refs;
+        for (int i = 0; i < WORLD_BLOCK_EVENTS_COUNT; i++) {
+            refs[i] = flags[i] ? lua::get_event_handlers(
+                L, packid + ":." + WORLD_BLOCK_EVENT_NAMES[i]
+            ) : LUA_NOREF;
+        }
+    }
+}
+
+static void release_events() {
+    auto L = lua::get_main_state();
+    for (const auto& refs : block_events) {
+        for (int ref : refs) {
+            lua::release_event_handlers(L, ref);
+        }
+    }
+    for (const auto& events : world_events) {
+        for (int ref : events.refs) {
+            lua::release_event_handlers(L, ref);
+        }
+    }
+    block_events.clear();
+    world_events.clear();
+}
+
+template <typename ArgsFunc>
+static bool emit_block_event(
+    const Block& block, BlockEvent event, const ArgsFunc& args
+) {
+    if (block.rt.id >= block_events.size()) {
+        return false;
+    }
+    lua::profiler::Scope scope("event", block.name, BLOCK_EVENT_NAMES[event]);
+    return lua::emit_event(
+        lua::get_main_state(), block_events[block.rt.id][event], args
+    );
+}
+
+template <typename ArgsFunc>
+static void emit_world_block_event(
+    WorldBlockEvent event, const ArgsFunc& args
+) {
+    auto L = lua::get_main_state();
+    for (const auto& events : world_events) {
+        if (events.refs[event] == LUA_NOREF) {
+            continue;
+        }
+        lua::profiler::Scope scope(
+            "event", events.packid, WORLD_BLOCK_EVENT_NAMES[event]
+        );
+        lua::emit_event(L, events.refs[event], args);
+    }
+}
+
 Engine* scripting::engine = nullptr;
 Level* scripting::level = nullptr;
 const Content* scripting::content = nullptr;
@@ -160,6 +281,7 @@ void scripting::on_world_load(LevelController* controller) {
     scripting::indices = level->content->getIndices();
     scripting::blocks = controller->getBlocksController();
     scripting::controller = controller;
+    resolve_events();
 
     auto L = lua::get_main_state();
     if (lua::getglobal(L, "__vc_on_world_open")) {
@@ -173,6 +295,7 @@ void scripting::on_world_load(LevelController* controller) {
 }
 
 void scripting::on_world_tick() {
+    PROFILE_SCOPE("scripting.world_tick");
     auto L = lua::get_main_state();
     for (auto& pack : scripting::engine->getContentPacks()) {
         lua::emit_event(L, pack.id + ":.worldtick");
@@ -197,6 +320,7 @@ void scripting::on_world_quit() {
     if (lua::getglobal(L, "__vc_on_world_quit")) {
         lua::call_nothrow(L, 0, 0);
     }
+    release_events();
     scripting::level = nullptr;
     scripting::content = nullptr;
     scripting::indices = nullptr;
@@ -220,104 +344,94 @@ void scripting::cleanup() {
 }
 
 void scripting::on_blocks_tick(const Block& block, int tps) {
-    std::string name = block.name + ".blockstick";
-    lua::emit_event(lua::get_main_state(), name, [tps](auto L) {
+    PROFILE_SCOPE("scripting.blocks_tick");
+    emit_block_event(block, BLOCK_EVENT_BLOCKSTICK, [tps](auto L) {
         return lua::pushinteger(L, tps);
     });
 }
 
 void scripting::update_block(const Block& block, const glm::ivec3& pos) {
-    std::string name = block.name + ".update";
-    lua::emit_event(lua::get_main_state(), name, [pos](auto L) {
+    emit_block_event(block, BLOCK_EVENT_UPDATE, [pos](auto L) {
         return lua::pushivec_stack(L, pos);
     });
 }
 
 void scripting::random_update_block(const Block& block, const glm::ivec3& pos) {
-    std::string name = block.name + ".randupdate";
-    lua::emit_event(lua::get_main_state(), name, [pos](auto L) {
+    emit_block_event(block, BLOCK_EVENT_RANDUPDATE, [pos](auto L) {
         return lua::pushivec_stack(L, pos);
     });
 }
 
+void scripting::random_update_blocks(
+    const Block& block, const std::vector<int32_t>& coords
+) {
+    PROFILE_SCOPE("scripting.random_update");
+    emit_block_event(
+        block, BLOCK_EVENT_RANDUPDATE_BATCH, [&coords](lua::State* L) {
+            lua::createtable(L, coords.size(), 0);
+            for (size_t i = 0; i < coords.size(); i++) {
+                lua::pushinteger(L, coords[i]);
+                lua::rawseti(L, i + 1);
+            }
+            lua::pushinteger(L, coords.size() / 3);
+            return 2;
+        }
+    );
+}
+
 void scripting::on_block_placed(
     Player* player, const Block& block, const glm::ivec3& pos
 ) {
     if (block.rt.funcsset.onplaced) {
-        std::string name = block.name + ".placed";
-        lua::emit_event(lua::get_main_state(), name, [pos, player](auto L) {
+        emit_block_event(block, BLOCK_EVENT_PLACED, [pos, player](auto L) {
             lua::pushivec_stack(L, pos);
             lua::pushinteger(L, player ? player->getId() : -1);
             return 4;
         });
     }
-    auto args = [&](lua::State* L) {
+    emit_world_block_event(WORLD_EVENT_BLOCKPLACED, [&](lua::State* L) {
         lua::pushinteger(L, block.rt.id);
         lua::pushivec_stack(L, pos);
         lua::pushinteger(L, player ? player->getId() : -1);
         return 5;
-    };
-    for (auto& [packid, pack] : content->getPacks()) {
-        if (pack->worldfuncsset.onblockplaced) {
-            lua::emit_event(
-                lua::get_main_state(), packid + ":.blockplaced", args
-            );
-        }
-    }
+    });
 }
 
 void scripting::on_block_broken(
     Player* player, const Block& block, const glm::ivec3& pos
 ) {
     if (block.rt.funcsset.onbroken) {
-        std::string name = block.name + ".broken";
-        lua::emit_event(
-            lua::get_main_state(),
-            name,
-            [pos, player](auto L) {
-                lua::pushivec_stack(L, pos);
-                lua::pushinteger(L, player ? player->getId() : -1);
-                return 4;
-            }
-        );
+        emit_block_event(block, BLOCK_EVENT_BROKEN, [pos, player](auto L) {
+            lua::pushivec_stack(L, pos);
+            lua::pushinteger(L, player ? player->getId() : -1);
+            return 4;
+        });
     }
-    auto args = [&](lua::State* L) {
+    emit_world_block_event(WORLD_EVENT_BLOCKBROKEN, [&](lua::State* L) {
         lua::pushinteger(L, block.rt.id);
         lua::pushivec_stack(L, pos);
         lua::pushinteger(L, player ? player->getId() : -1);
         return 5;
-    };
-    for (auto& [packid, pack] : content->getPacks()) {
-        if (pack->worldfuncsset.onblockbroken) {
-            lua::emit_event(
-                lua::get_main_state(), packid + ":.blockbroken", args
-            );
-        }
-    }
+    });
 }
 
 bool scripting::on_block_interact(
     Player* player, const Block& block, const glm::ivec3& pos
 ) {
-    std::string name = block.name + ".interact";
-    return lua::emit_event(lua::get_main_state(), name, [pos, player](auto L) {
-        lua::pushivec_stack(L, pos);
-        lua::pushinteger(L, player->getId());
-        return 4;
-    });
-    auto args = [&](lua::State* L) {
+    bool result = emit_block_event(
+        block, BLOCK_EVENT_INTERACT, [pos, player](auto L) {
+            lua::pushivec_stack(L, pos);
+            lua::pushinteger(L, player->getId());
+            return 4;
+        }
+    );
+    emit_world_block_event(WORLD_EVENT_BLOCKINTERACT, [&](lua::State* L) {
         lua::pushinteger(L, block.rt.id);
         lua::pushivec_stack(L, pos);
         lua::pushinteger(L, player ? player->getId() : -1);
         return 5;
-    };
-    for (auto& [packid, pack] : content->getPacks()) {
-        if (pack->worldfuncsset.onblockinteract) {
-            lua::emit_event(
-                lua::get_main_state(), packid + ":.blockinteract", args
-            );
-        }
-    }
+    });
+    return result;
 }
 
 bool scripting::on_item_use(Player* player, const ItemDef& item) {
@@ -467,6 +581,9 @@ static void process_entity_callback(
     const auto& script = entity.getScripting();
     for (auto& component : script.components) {
         if (component->funcsset.*flag) {
+            lua::profiler::Scope scope(
+                "component", component->name, name.c_str()
+            );
             process_entity_callback(component->env, name, args);
         }
     }
@@ -576,6 +693,9 @@ void scripting::on_entity_used(const Entity& entity, Player* player) {
 }
 
 void scripting::on_entities_update(int tps, int parts, int part) {
+    PROFILE_SCOPE("scripting.entities_update");
+    static const std::string scopeName = "update";
+    lua::profiler::Scope scope("entities", scopeName);
     auto L = lua::get_main_state();
     lua::get_from(L, STDCOMP, "update", true);
     lua::pushinteger(L, tps);
@@ -586,6 +706,8 @@ void scripting::on_entities_update(int tps, int parts, int part) {
 }
 
 void scripting::on_entities_render(float delta) {
+    static const std::string scopeName = "render";
+    lua::profiler::Scope scope("entities", scopeName);
     auto L = lua::get_main_state();
     lua::get_from(L, STDCOMP, "render", true);
     lua::pushnumber(L, delta);
@@ -665,6 +787,9 @@ void scripting::load_block_script(
     funcsset.update = register_event(env, "on_update", prefix + ".update");
     funcsset.randupdate =
         register_event(env, "on_random_update", prefix + ".randupdate");
+    funcsset.randupdatebatch = register_event(
+        env, "on_random_update_batch", prefix + ".randupdatebatch"
+    );
     funcsset.onbroken = register_event(env, "on_broken", prefix + ".broken");
     funcsset.onplaced = register_event(env, "on_placed", prefix + ".placed");
     funcsset.oninteract =
@@ -66,6 +66,11 @@ namespace scripting {
     void on_blocks_tick(const Block& block, int tps);
     void update_block(const Block& block, const glm::ivec3& pos);
     void random_update_block(const Block& block, const glm::ivec3& pos);
+    /// @brief Call random update handler once for all the block hits
+    /// @param coords flat coordinates list {x1, y1, z1, x2, y2, z2, ...}
+    void random_update_blocks(
+        const Block& block, const std::vector<int32_t>& coords
+    );
     void on_block_placed(
         Player* player, const Block& block, const glm::ivec3& pos
     );
@@ -7,6 +7,7 @@
 #include "typedefs.hpp"
 #include "lua/lua_engine.hpp"
 #include "lua/lua_custom_types.hpp"
+#include "lua/lua_profiler.hpp"
 #include "content/Content.hpp"
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
@@ -70,6 +71,7 @@ public:
         uint bpd,
         const std::vector<std::shared_ptr<Heightmap>>& inputs
     ) override {
+        lua::profiler::Scope scope("generator", def.name, "generate_heightmap");
         pushenv(L, *env);
         if (getfield(L, "generate_heightmap")) {
             pushivec_stack(L, offset);
@@ -99,6 +101,7 @@ public:
         std::vector<std::shared_ptr<Heightmap>> maps;
 
         uint biomeParameters = def.biomeParameters;
+        lua::profiler::Scope scope("generator", def.name, "generate_biome_parameters");
         pushenv(L, *env);
         if (getfield(L, "generate_biome_parameters")) {
             pushivec_stack(L, offset);
@@ -195,6 +198,7 @@ public:
         std::vector<Placement> placements {};
         
         stackguard _(L);
+        lua::profiler::Scope scope("generator", def.name, "place_structures_wide");
         pushenv(L, *env);
         try {
             if (getfield(L, "place_structures_wide")) {
@@ -228,6 +232,7 @@ public:
         std::vector<Placement> placements {};
         
         stackguard _(L);
+        lua::profiler::Scope scope("generator", def.name, "place_structures");
         pushenv(L, *env);
         if (getfield(L, "place_structures")) {
             pushivec_stack(L, offset);
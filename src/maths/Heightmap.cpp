@@ -16,83 +16,192 @@ std::optional<InterpolationType> InterpolationType_from(std::string_view str) {
     return std::nullopt;
 }
 
-static inline float sample_at(
-    const float* buffer,
-    uint width,
-    uint x, uint y
-) {
-    return buffer[y*width+x];
+static inline uint clamp_index(uint index, uint size) {
+    return index >= size ? size - 1 : index;
 }
 
-static inline float sample_at(
-    const float* buffer,
-    uint width, uint height,
-    uint x, uint y
+static inline float interpolate_cubic(
+    float p0, float p1, float p2, float p3, float x
 ) {
-    return buffer[(y >= height ? height-1 : y)*width+(x >= width ? width-1 : x)];
+    return p1 + 0.5 * x*(p2 - p0 + x*(2.0*p0 - 5.0*p1 + 4.0*p2 - 
+           p3 + x*(3.0*(p1 - p2) + p3 - p0)));
 }
 
-static inline float interpolate_cubic(float p[4], float x) {
-    return p[1] + 0.5 * x*(p[2] - p[0] + x*(2.0*p[0] - 5.0*p[1] + 4.0*p[2] - 
-           p[3] + x*(3.0*(p[1] - p[2]) + p[3] - p[0])));
+namespace {
+    /// @brief Resampling temporary buffers reused between calls
+    struct ResampleScratch {
+        std::vector<uint> columns[4];
+        std::vector<float> columnsFractions;
+        std::vector<uint> rows;
+        std::vector<float> rowsFractions;
+        /// @brief Horizontal pass results
+        std::vector<float> values;
+        std::vector<bool> valuesReady;
+    };
 }
 
-static inline float interpolate_bicubic(float p[4][4], float x, float y) {
-    float q[4];
-    for (int i = 0; i < 4; i++) {
-        q[i] = interpolate_cubic(p[i], y);
+static thread_local ResampleScratch scratch;
+
+/// @brief Calculate source positions of destination columns or rows
+/// @param srcSize source size
+/// @param dstSize full destination size
+/// @param from first calculated destination position
+/// @param count number of calculated positions
+static void calculate_positions(
+    uint srcSize,
+    uint dstSize,
+    uint from,
+    uint count,
+    std::vector<uint>& indices,
+    std::vector<float>& fractions
+) {
+    indices.resize(count);
+    fractions.resize(count);
+    for (uint i = 0; i < count; i++) {
+        float pos = static_cast<float>(from + i) / dstSize * srcSize;
+        // std::floor is redundant here because pos is a positive value
+        uint index = static_cast<uint>(pos);
+        indices[i] = index;
+        fractions[i] = pos - index;
     }
-    return interpolate_cubic(q, x);
 }
 
-static inline float sample_at(
-    const float* buffer,
-    uint width, uint height,
-    float x, float y,
+/// @brief Resample source map to the zone of virtual dstWidth x dstHeight
+/// map. Interpolation is split into horizontal and vertical passes, inner
+/// loops have no branches to be vectorized by compiler
+static void resample(
+    const float* src,
+    uint width,
+    uint height,
+    float* dst,
+    uint dstWidth,
+    uint dstHeight,
+    uint zoneX,
+    uint zoneY,
+    uint zoneWidth,
+    uint zoneHeight,
     InterpolationType interp
 ) {
-    // std::floor is redundant here because x and y are positive values
-    uint ix = static_cast<uint>(x);
-    uint iy = static_cast<uint>(y);
-    float val = buffer[iy*width+ix];
-    if (interp == InterpolationType::NEAREST) {
-        return val;
-    }
-    float tx = x - ix;
-    float ty = y - iy;
+    auto& columns = scratch.columns;
+    const auto& tx = scratch.columnsFractions;
+    const auto& rows = scratch.rows;
+    const auto& ty = scratch.rowsFractions;
+    calculate_positions(
+        width, dstWidth, zoneX, zoneWidth, columns[1],
+        scratch.columnsFractions
+    );
+    calculate_positions(
+        height, dstHeight, zoneY, zoneHeight, scratch.rows,
+        scratch.rowsFractions
+    );
 
     switch (interp) {
+        case InterpolationType::NEAREST: {
+            const uint* ix = columns[1].data();
+            for (uint y = 0; y < zoneHeight; y++) {
+                const float* row = src + rows[y] * width;
+                float* out = dst + y * zoneWidth;
+                for (uint x = 0; x < zoneWidth; x++) {
+                    out[x] = row[ix[x]];
+                }
+            }
+            break;
+        }
         case InterpolationType::LINEAR: {
-            float s00 = val;
-            float s10 = sample_at(buffer, width, 
-                ix + 1 < width ? ix + 1 : ix, iy);
-            float s01 = sample_at(buffer, width, ix, 
-                iy + 1 < height ? iy + 1 : iy);
-            float s11 = sample_at(buffer, width, 
-                ix + 1 < width ? ix + 1 : ix, iy + 1 < height ? iy + 1 : iy);
-
-            float a00 = s00;
-            float a10 = s10 - s00;
-            float a01 = s01 - s00;
-            float a11 = s11 - s10 - s01 + s00;
-
-            return a00 + a10*tx + a01*ty + a11*tx*ty;
+            columns[2].resize(zoneWidth);
+            for (uint x = 0; x < zoneWidth; x++) {
+                uint ix = columns[1][x];
+                columns[2][x] = ix + 1 < width ? ix + 1 : ix;
+            }
+            const uint* ix0 = columns[1].data();
+            const uint* ix1 = columns[2].data();
+            // a00 + a10*tx, a01, a11*tx of the current source rows pair
+            auto& coefs = scratch.values;
+            coefs.resize(zoneWidth * 3);
+            float* ca = coefs.data();
+            float* cb = ca + zoneWidth;
+            float* cc = cb + zoneWidth;
+            uint currentRow = height;
+            for (uint y = 0; y < zoneHeight; y++) {
+                uint iy = rows[y];
+                if (iy != currentRow) {
+                    currentRow = iy;
+                    const float* row0 = src + iy * width;
+                    const float* row1 =
+                        src + (iy + 1 < height ? iy + 1 : iy) * width;
+                    for (uint x = 0; x < zoneWidth; x++) {
+                        float s00 = row0[ix0[x]];
+                        float s10 = row0[ix1[x]];
+                        float s01 = row1[ix0[x]];
+                        float s11 = row1[ix1[x]];
+                        float a10 = s10 - s00;
+                        float a11 = s11 - s10 - s01 + s00;
+                        ca[x] = s00 + a10*tx[x];
+                        cb[x] = s01 - s00;
+                        cc[x] = a11*tx[x];
+                    }
+                }
+                float fy = ty[y];
+                float* out = dst + y * zoneWidth;
+                for (uint x = 0; x < zoneWidth; x++) {
+                    out[x] = ca[x] + cb[x]*fy + cc[x]*fy;
+                }
+            }
+            break;
         }
         case InterpolationType::CUBIC: {
-            float p[4][4];
-            for (int i = 0; i < 4; i++) {
-                for (int j = 0; j < 4; j++) {
-                    p[i][j] = sample_at(
-                        buffer, width, height, ix + j - 1, iy + i - 1
+            for (int j = 0; j < 4; j++) {
+                if (j == 1) {
+                    continue;
+                }
+                columns[j].resize(zoneWidth);
+                for (uint x = 0; x < zoneWidth; x++) {
+                    columns[j][x] = clamp_index(columns[1][x] + j - 1, width);
+                }
+            }
+            for (uint x = 0; x < zoneWidth; x++) {
+                columns[1][x] = clamp_index(columns[1][x], width);
+            }
+            const uint* c0 = columns[0].data();
+            const uint* c1 = columns[1].data();
+            const uint* c2 = columns[2].data();
+            const uint* c3 = columns[3].data();
+
+            // horizontal pass is calculated once per used source row
+            auto& hrows = scratch.values;
+            auto& ready = scratch.valuesReady;
+            hrows.resize(height * zoneWidth);
+            ready.assign(height, false);
+            for (uint y = 0; y < zoneHeight; y++) {
+                float* hrow[4];
+                for (int i = 0; i < 4; i++) {
+                    uint iy = clamp_index(rows[y] + i - 1, height);
+                    hrow[i] = hrows.data() + iy * zoneWidth;
+                    if (ready[iy]) {
+                        continue;
+                    }
+                    ready[iy] = true;
+                    const float* row = src + iy * width;
+                    for (uint x = 0; x < zoneWidth; x++) {
+                        hrow[i][x] = interpolate_cubic(
+                            row[c0[x]], row[c1[x]], row[c2[x]], row[c3[x]],
+                            tx[x]
+                        );
+                    }
+                }
+                float fy = ty[y];
+                float* out = dst + y * zoneWidth;
+                for (uint x = 0; x < zoneWidth; x++) {
+                    out[x] = interpolate_cubic(
+                        hrow[0][x], hrow[1][x], hrow[2][x], hrow[3][x], fy
                     );
                 }
             }
-            return interpolate_bicubic(p, ty, tx);
+            break;
         }
         default:
             throw std::runtime_error("interpolation type is not implemented");
     }
-    return val;
 }
 
 void Heightmap::resize(
@@ -101,18 +210,38 @@ void Heightmap::resize(
     if (width == dstwidth && height == dstheight) {
         return;
     }
-    std::vector<float> dst;
-    dst.resize(dstwidth*dstheight);
+    std::vector<float> dst(dstwidth*dstheight);
+    resample(
+        buffer.data(), width, height, dst.data(), dstwidth, dstheight,
+        0, 0, dstwidth, dstheight, interp
+    );
+    width = dstwidth;
+    height = dstheight;
+    buffer = std::move(dst);
+}
 
-    uint index = 0;
-    for (uint y = 0; y < dstheight; y++) {
-        for (uint x = 0; x < dstwidth; x++, index++) {
-            float sx = static_cast<float>(x) / dstwidth * width;
-            float sy = static_cast<float>(y) / dstheight * height;
-            dst[index] = sample_at(buffer.data(), width, height, sx, sy, interp);
-        }
+void Heightmap::resizeAndCrop(
+    uint resizedWidth,
+    uint resizedHeight,
+    uint srcx,
+    uint srcy,
+    uint dstwidth,
+    uint dstheight,
+    InterpolationType interp
+) {
+    if (srcx + dstwidth > resizedWidth || srcy + dstheight > resizedHeight) {
+        throw std::runtime_error(
+            "crop zone is not fully inside of the source image");
     }
-
+    if (width == resizedWidth && height == resizedHeight) {
+        crop(srcx, srcy, dstwidth, dstheight);
+        return;
+    }
+    std::vector<float> dst(dstwidth*dstheight);
+    resample(
+        buffer.data(), width, height, dst.data(), resizedWidth, resizedHeight,
+        srcx, srcy, dstwidth, dstheight, interp
+    );
     width = dstwidth;
     height = dstheight;
     buffer = std::move(dst);
@@ -128,20 +257,16 @@ void Heightmap::crop(
     if (dstwidth == width && dstheight == height) {
         return;
     }
-
-    std::vector<float> dst;
-    dst.resize(dstwidth*dstheight);
-
+    // rows are moved towards the buffer start, so it's done in place
     for (uint y = 0; y < dstheight; y++) {
-        std::memcpy(
-            dst.data()+y*dstwidth, 
+        std::memmove(
+            buffer.data()+y*dstwidth, 
             buffer.data()+(y+srcy)*width+srcx, 
             dstwidth*sizeof(float));
     }
-
     width = dstwidth;
     height = dstheight;
-    buffer = std::move(dst);
+    buffer.resize(dstwidth*dstheight);
 }
 
 void Heightmap::clamp() {
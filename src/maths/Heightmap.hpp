@@ -31,6 +31,25 @@ public:
 
     void resize(uint width, uint height, InterpolationType interpolation);
 
+    /// @brief Resize and crop in one pass. Values outside of the crop zone
+    /// are not calculated
+    /// @param width resized map width
+    /// @param height resized map height
+    /// @param srcX crop zone X in the resized map
+    /// @param srcY crop zone Y in the resized map
+    /// @param dstWidth crop zone width
+    /// @param dstHeight crop zone height
+    void resizeAndCrop(
+        uint width,
+        uint height,
+        uint srcX,
+        uint srcY,
+        uint dstWidth,
+        uint dstHeight,
+        InterpolationType interpolation
+    );
+
+    /// @brief Crop map in place without reallocation
     void crop(uint srcX, uint srcY, uint dstWidth, uint dstHeight);
 
     void clamp();
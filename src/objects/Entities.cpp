@@ -5,8 +5,8 @@
 
 #include "assets/Assets.hpp"
 #include "content/Content.hpp"
-#include "data/dv_util.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "engine.hpp"
 #include "graphics/core/DrawContext.hpp"
 #include "graphics/core/LineBatch.hpp"
@@ -16,6 +16,7 @@
 #include "maths/FrustumCulling.hpp"
 #include "maths/rays.hpp"
 #include "EntityDef.hpp"
+#include "entities_io.hpp"
 #include "rigging.hpp"
 #include "physics/Hitbox.hpp"
 #include "physics/PhysicsSolver.hpp"
@@ -23,9 +24,6 @@
 
 static debug::Logger logger("entities");
 
-static inline std::string COMP_TRANSFORM = "transform";
-static inline std::string COMP_RIGIDBODY = "rigidbody";
-static inline std::string COMP_SKELETON = "skeleton";
 static inline std::string SAVED_DATA_VARNAME = "SAVED_DATA";
 
 void Transform::refresh() {
@@ -114,7 +112,7 @@ entityid_t Entities::spawn(
     const EntityDef& def,
     glm::vec3 position,
     dv::value args,
-    dv::value saved,
+    const SavedEntity* saved,
     entityid_t uid
 ) {
     auto skeleton = level->content->getSkeleton(def.skeletonName);
@@ -168,8 +166,8 @@ entityid_t Entities::spawn(
     }
     dv::value componentsMap = nullptr;
     if (saved != nullptr) {
-        componentsMap = saved["comps"];
-        loadEntity(saved, get(id).value());
+        componentsMap = saved->components;
+        loadEntity(*saved, get(id).value());
     }
     body.hitbox.position = tsf.pos;
     scripting::on_entity_spawn(
@@ -187,56 +185,42 @@ void Entities::despawn(entityid_t id) {
     }
 }
 
-void Entities::loadEntity(const dv::value& map) {
-    entityid_t uid = map["uid"].asInteger();
-    std::string defname = map["def"].asString();
-    auto& def = level->content->entities.require(defname);
-    spawn(def, {}, nullptr, map, uid);
+void Entities::loadEntity(const SavedEntity& saved) {
+    auto& def = level->content->entities.require(saved.def);
+    spawn(def, {}, nullptr, &saved, saved.uid);
 }
 
-void Entities::loadEntity(const dv::value& map, Entity entity) {
+void Entities::loadEntity(const SavedEntity& saved, Entity entity) {
     auto& transform = entity.getTransform();
     auto& body = entity.getRigidbody();
     auto& skeleton = entity.getSkeleton();
 
-    if (map.has(COMP_RIGIDBODY)) {
-        auto& bodymap = map[COMP_RIGIDBODY];
-        dv::get_vec(bodymap, "vel", body.hitbox.velocity);
-        std::string bodyTypeName;
-        map.at("type").get(bodyTypeName);
-        if (auto bodyType = BodyType_from(bodyTypeName)) {
-            body.hitbox.type = *bodyType;
-        }
-        bodymap["crouch"].asBoolean(body.hitbox.crouching);
-        bodymap["damping"].asNumber(body.hitbox.linearDamping);
-    }
-    if (map.has(COMP_TRANSFORM)) {
-        auto& tsfmap = map[COMP_TRANSFORM];
-        dv::get_vec(tsfmap, "pos", transform.pos);
-        dv::get_vec(tsfmap, "size", transform.size);
-        dv::get_mat(tsfmap, "rot", transform.rot);
-    }
-    std::string skeletonName = skeleton.config->getName();
-    map.at("skeleton").get(skeletonName);
-    if (skeletonName != skeleton.config->getName()) {
-        skeleton.config = level->content->getSkeleton(skeletonName);
-    }
-    if (auto found = map.at(COMP_SKELETON)) {
-        auto& skeletonmap = *found;
-        if (auto found = skeletonmap.at("textures")) {
-            auto& texturesmap = *found;
-            for (auto& [slot, _] : texturesmap.asObject()) {
-                texturesmap.at(slot).get(skeleton.textures[slot]);
-            }
-        }
-        if (auto found = skeletonmap.at("pose")) {
-            auto& posearr = *found;
-            for (size_t i = 0;
-                 i < std::min(skeleton.pose.matrices.size(), posearr.size());
-                 i++) {
-                dv::get_mat(posearr[i], skeleton.pose.matrices[i]);
-            }
-        }
+    if (saved.velocity) {
+        body.hitbox.velocity = *saved.velocity;
+    }
+    if (saved.bodyType) {
+        body.hitbox.type = *saved.bodyType;
+    }
+    if (saved.damping) {
+        body.hitbox.linearDamping = *saved.damping;
+    }
+    body.hitbox.crouching = saved.crouching;
+
+    transform.pos = saved.pos;
+    transform.size = saved.size;
+    transform.rot = saved.rot;
+
+    if (!saved.skeleton.empty() &&
+        saved.skeleton != skeleton.config->getName()) {
+        skeleton.config = level->content->getSkeleton(saved.skeleton);
+    }
+    for (const auto& [slot, texture] : saved.textures) {
+        skeleton.textures[slot] = texture;
+    }
+    for (size_t i = 0;
+         i < std::min(skeleton.pose.matrices.size(), saved.pose.size());
+         i++) {
+        skeleton.pose.matrices[i] = saved.pose[i];
     }
 }
 
@@ -271,12 +255,11 @@ std::optional<Entities::RaycastResult> Entities::rayCast(
     }
 }
 
-void Entities::loadEntities(dv::value root) {
+void Entities::loadEntities(const std::vector<SavedEntity>& entities) {
     clean();
-    auto& list = root["data"];
-    for (auto& map : list) {
+    for (const auto& saved : entities) {
         try {
-            loadEntity(map);
+            loadEntity(saved);
         } catch (const std::runtime_error& err) {
             logger.error() << "could not read entity: " << err.what();
         }
@@ -287,84 +270,66 @@ void Entities::onSave(const Entity& entity) {
     scripting::on_entity_save(entity);
 }
 
-dv::value Entities::serialize(const Entity& entity) {
-    auto root = dv::object();
+SavedEntity Entities::serialize(const Entity& entity) {
+    SavedEntity saved;
     auto& eid = entity.getID();
     auto& def = eid.def;
-    root["def"] = def.name;
-    root["uid"] = eid.uid;
+    saved.def = def.name;
+    saved.uid = eid.uid;
     {
         auto& transform = entity.getTransform();
-        auto& tsfmap = root.object(COMP_TRANSFORM);
-        tsfmap["pos"] = dv::to_value(transform.pos);
-        if (transform.size != glm::vec3(1.0f)) {
-            tsfmap["size"] = dv::to_value(transform.size);
-        }
-        if (transform.rot != glm::mat3(1.0f)) {
-            tsfmap["rot"] = dv::to_value(transform.rot);
-        }
+        saved.pos = transform.pos;
+        saved.size = transform.size;
+        saved.rot = transform.rot;
     }
     {
         auto& rigidbody = entity.getRigidbody();
         auto& hitbox = rigidbody.hitbox;
-        auto& bodymap = root.object(COMP_RIGIDBODY);
-        if (!rigidbody.enabled) {
-            bodymap["enabled"] = false;
-        }
+        saved.bodyEnabled = rigidbody.enabled;
         if (def.save.body.velocity) {
-            bodymap["vel"] = dv::to_value(rigidbody.hitbox.velocity);
+            saved.velocity = hitbox.velocity;
         }
         if (def.save.body.settings) {
-            bodymap["damping"] = rigidbody.hitbox.linearDamping;
+            saved.damping = hitbox.linearDamping;
             if (hitbox.type != def.bodyType) {
-                bodymap["type"] = to_string(hitbox.type);
-            }
-            if (hitbox.crouching) {
-                bodymap["crouch"] = hitbox.crouching;
+                saved.bodyType = hitbox.type;
             }
+            saved.crouching = hitbox.crouching;
         }
     }
     auto& skeleton = entity.getSkeleton();
     if (skeleton.config->getName() != def.skeletonName) {
-        root["skeleton"] = skeleton.config->getName();
-    }
-    if (def.save.skeleton.pose || def.save.skeleton.textures) {
-        auto& skeletonmap = root.object(COMP_SKELETON);
-        if (def.save.skeleton.textures) {
-            auto& map = skeletonmap.object("textures");
-            for (auto& [slot, texture] : skeleton.textures) {
-                map[slot] = texture;
-            }
-        }
-        if (def.save.skeleton.pose) {
-            auto& list = skeletonmap.list("pose");
-            for (auto& mat : skeleton.pose.matrices) {
-                list.add(dv::to_value(mat));
-            }
-        }
+        saved.skeleton = skeleton.config->getName();
+    }
+    if (def.save.skeleton.textures) {
+        saved.textures = skeleton.textures;
+    }
+    if (def.save.skeleton.pose) {
+        saved.pose = skeleton.pose.matrices;
     }
     auto& scripts = entity.getScripting();
     if (!scripts.components.empty()) {
-        auto& compsMap = root.object("comps");
+        saved.components = dv::object();
         for (auto& comp : scripts.components) {
             auto data =
                 scripting::get_component_value(comp->env, SAVED_DATA_VARNAME);
-            compsMap[comp->name] = data;
+            saved.components[comp->name] = data;
         }
     }
-    return root;
+    return saved;
 }
 
-dv::value Entities::serialize(const std::vector<Entity>& entities) {
-    auto list = dv::list();
+std::vector<ubyte> Entities::serialize(const std::vector<Entity>& entities) {
+    std::vector<SavedEntity> saved;
+    saved.reserve(entities.size());
     for (auto& entity : entities) {
         if (!entity.getDef().save.enabled) {
             continue;
         }
         level->entities->onSave(entity);
-        list.add(level->entities->serialize(entity));
+        saved.push_back(level->entities->serialize(entity));
     }
-    return list;
+    return entities_io::encode(saved);
 }
 
 void Entities::despawn(std::vector<Entity> entities) {
@@ -444,6 +409,7 @@ void Entities::preparePhysics(float delta) {
 }
 
 void Entities::updatePhysics(float delta) {
+    PROFILE_SCOPE("entities.physics");
     preparePhysics(delta);
 
     auto view = registry.view<EntityId, Transform, Rigidbody>();
@@ -474,6 +440,7 @@ void Entities::updatePhysics(float delta) {
 }
 
 void Entities::update(float delta) {
+    PROFILE_SCOPE("entities.update");
     if (updateTickClock.update(delta)) {
         scripting::on_entities_update(
             updateTickClock.getTickRate(),
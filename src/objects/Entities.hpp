@@ -29,6 +29,7 @@ struct entity_funcs_set {
 };
 
 struct EntityDef;
+struct SavedEntity;
 
 struct EntityId {
     entityid_t uid;
@@ -205,7 +206,7 @@ public:
         const EntityDef& def,
         glm::vec3 position,
         dv::value args = nullptr,
-        dv::value saved = nullptr,
+        const SavedEntity* saved = nullptr,
         entityid_t uid = 0
     );
 
@@ -231,17 +232,18 @@ public:
         entityid_t ignore = -1
     );
 
-    void loadEntities(dv::value map);
-    void loadEntity(const dv::value& map);
-    void loadEntity(const dv::value& map, Entity entity);
+    void loadEntities(const std::vector<SavedEntity>& entities);
+    void loadEntity(const SavedEntity& saved);
+    void loadEntity(const SavedEntity& saved, Entity entity);
     void onSave(const Entity& entity);
     bool hasBlockingInside(AABB aabb);
     std::vector<Entity> getAllInside(AABB aabb);
     std::vector<Entity> getAllInRadius(glm::vec3 center, float radius);
     void despawn(entityid_t id);
     void despawn(std::vector<Entity> entities);
-    dv::value serialize(const Entity& entity);
-    dv::value serialize(const std::vector<Entity>& entities);
+    SavedEntity serialize(const Entity& entity);
+    /// @brief Encode saved entities to the entities region layer format
+    std::vector<ubyte> serialize(const std::vector<Entity>& entities);
 
     void setNextID(entityid_t id) {
         nextID = id;
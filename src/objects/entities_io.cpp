@@ -0,0 +1,369 @@
+#include "entities_io.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "coders/binary_json.hpp"
+#include "coders/byte_utils.hpp"
+#include "coders/gzip.hpp"
+#include "data/dv_util.hpp"
+
+using namespace entities_io;
+
+enum EntityFlags : uint16_t {
+    FLAG_SIZE = 1 << 0,
+    FLAG_ROT = 1 << 1,
+    FLAG_BODY_DISABLED = 1 << 2,
+    FLAG_VELOCITY = 1 << 3,
+    FLAG_DAMPING = 1 << 4,
+    FLAG_BODY_TYPE = 1 << 5,
+    FLAG_CROUCHING = 1 << 6,
+    FLAG_SKELETON = 1 << 7,
+    FLAG_TEXTURES = 1 << 8,
+    FLAG_POSE = 1 << 9,
+};
+
+static uint16_t get_flags(const SavedEntity& entity) {
+    uint16_t flags = 0;
+    if (entity.size != glm::vec3(1.0f)) flags |= FLAG_SIZE;
+    if (entity.rot != glm::mat3(1.0f)) flags |= FLAG_ROT;
+    if (!entity.bodyEnabled) flags |= FLAG_BODY_DISABLED;
+    if (entity.velocity) flags |= FLAG_VELOCITY;
+    if (entity.damping) flags |= FLAG_DAMPING;
+    if (entity.bodyType) flags |= FLAG_BODY_TYPE;
+    if (entity.crouching) flags |= FLAG_CROUCHING;
+    if (!entity.skeleton.empty()) flags |= FLAG_SKELETON;
+    if (!entity.textures.empty()) flags |= FLAG_TEXTURES;
+    if (!entity.pose.empty()) flags |= FLAG_POSE;
+    return flags;
+}
+
+template <int n>
+static void put_vec(ByteBuilder& builder, const glm::vec<n, float>& vec) {
+    for (int i = 0; i < n; i++) {
+        builder.putFloat32(vec[i]);
+    }
+}
+
+template <int n, int m>
+static void put_mat(ByteBuilder& builder, const glm::mat<n, m, float>& mat) {
+    for (int i = 0; i < n; i++) {
+        put_vec(builder, mat[i]);
+    }
+}
+
+template <int n>
+static void get_vec(ByteReader& reader, glm::vec<n, float>& vec) {
+    for (int i = 0; i < n; i++) {
+        vec[i] = reader.getFloat32();
+    }
+}
+
+template <int n, int m>
+static void get_mat(ByteReader& reader, glm::mat<n, m, float>& mat) {
+    for (int i = 0; i < n; i++) {
+        get_vec(reader, mat[i]);
+    }
+}
+
+namespace {
+    class StringsTable {
+        std::unordered_map<std::string, uint32_t> indices;
+        std::vector<const std::string*> strings;
+    public:
+        uint32_t add(const std::string& string) {
+            auto [found, inserted] = indices.try_emplace(
+                string, static_cast<uint32_t>(strings.size())
+            );
+            if (inserted) {
+                strings.push_back(&found->first);
+            }
+            return found->second;
+        }
+
+        void write(ByteBuilder& builder) const {
+            builder.putInt32(strings.size());
+            for (const auto string : strings) {
+                builder.put(*string);
+            }
+        }
+    };
+}
+
+std::vector<ubyte> entities_io::encode(
+    const std::vector<SavedEntity>& entities
+) {
+    StringsTable strings;
+    std::vector<uint32_t> defs;
+    defs.reserve(entities.size());
+    for (const auto& entity : entities) {
+        defs.push_back(strings.add(entity.def));
+        if (!entity.skeleton.empty()) {
+            strings.add(entity.skeleton);
+        }
+        for (const auto& [slot, texture] : entity.textures) {
+            strings.add(slot);
+            strings.add(texture);
+        }
+    }
+    ByteBuilder builder;
+    builder.putInt32(entities.size());
+    strings.write(builder);
+    for (uint32_t def : defs) {
+        builder.putInt32(def);
+    }
+    for (const auto& entity : entities) {
+        builder.putInt64(entity.uid);
+    }
+    std::vector<uint16_t> flags;
+    flags.reserve(entities.size());
+    for (const auto& entity : entities) {
+        flags.push_back(get_flags(entity));
+        builder.putInt16(flags.back());
+    }
+    for (const auto& entity : entities) {
+        put_vec(builder, entity.pos);
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (flags[i] & FLAG_SIZE) put_vec(builder, entities[i].size);
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (flags[i] & FLAG_ROT) put_mat(builder, entities[i].rot);
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (flags[i] & FLAG_VELOCITY) put_vec(builder, *entities[i].velocity);
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (flags[i] & FLAG_DAMPING) builder.putFloat32(*entities[i].damping);
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (flags[i] & FLAG_BODY_TYPE) {
+            builder.put(static_cast<ubyte>(*entities[i].bodyType));
+        }
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (flags[i] & FLAG_SKELETON) {
+            builder.putInt32(strings.add(entities[i].skeleton));
+        }
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (flags[i] & FLAG_TEXTURES) {
+            const auto& textures = entities[i].textures;
+            builder.putInt32(textures.size());
+            for (const auto& [slot, texture] : textures) {
+                builder.putInt32(strings.add(slot));
+                builder.putInt32(strings.add(texture));
+            }
+        }
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (flags[i] & FLAG_POSE) {
+            const auto& pose = entities[i].pose;
+            builder.putInt32(pose.size());
+            for (const auto& matrix : pose) {
+                put_mat(builder, matrix);
+            }
+        }
+    }
+    auto components = dv::list();
+    for (const auto& entity : entities) {
+        if (entity.components.isObject()) {
+            components.add(entity.components);
+        } else {
+            components.add(dv::object());
+        }
+    }
+    auto componentsRoot = dv::object();
+    componentsRoot["data"] = std::move(components);
+    size_t sizePosition = builder.size();
+    builder.putInt32(0);
+    json::to_binary(builder, componentsRoot);
+    builder.setInt32(
+        sizePosition, builder.size() - sizePosition - sizeof(int32_t)
+    );
+
+    ByteBuilder output;
+    output.put(MAGIC);
+    output.put(VERSION);
+    gzip::compress(builder.data(), builder.size(), output);
+    return output.build();
+}
+
+static std::vector<std::string> read_strings(ByteReader& reader) {
+    uint32_t count = reader.getInt32();
+    std::vector<std::string> strings;
+    strings.reserve(std::min<size_t>(count, reader.remaining()));
+    for (uint32_t i = 0; i < count; i++) {
+        strings.push_back(reader.getString());
+    }
+    return strings;
+}
+
+static const std::string& get_string(
+    const std::vector<std::string>& strings, uint32_t index
+) {
+    if (index >= strings.size()) {
+        throw std::runtime_error("invalid string index");
+    }
+    return strings[index];
+}
+
+static std::vector<SavedEntity> decode_columns(ByteReader& reader) {
+    // components are only kept until entities are spawned
+    dv::ArenaScope arena;
+    uint32_t count = reader.getInt32();
+    if (count > reader.remaining()) {
+        throw std::runtime_error("invalid entities count");
+    }
+    auto strings = read_strings(reader);
+    std::vector<SavedEntity> entities(count);
+    for (auto& entity : entities) {
+        entity.def = get_string(strings, reader.getInt32());
+    }
+    for (auto& entity : entities) {
+        entity.uid = reader.getInt64();
+    }
+    std::vector<uint16_t> flags(count);
+    for (uint32_t i = 0; i < count; i++) {
+        flags[i] = reader.getInt16();
+        entities[i].bodyEnabled = !(flags[i] & FLAG_BODY_DISABLED);
+        entities[i].crouching = flags[i] & FLAG_CROUCHING;
+    }
+    for (auto& entity : entities) {
+        get_vec(reader, entity.pos);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] & FLAG_SIZE) get_vec(reader, entities[i].size);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] & FLAG_ROT) get_mat(reader, entities[i].rot);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] & FLAG_VELOCITY) {
+            get_vec(reader, entities[i].velocity.emplace());
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] & FLAG_DAMPING) entities[i].damping = reader.getFloat32();
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] & FLAG_BODY_TYPE) {
+            // unknown body type is ignored as in the json format
+            ubyte bodyType = reader.get();
+            if (bodyType <= static_cast<ubyte>(BodyType::DYNAMIC)) {
+                entities[i].bodyType = static_cast<BodyType>(bodyType);
+            }
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] & FLAG_SKELETON) {
+            entities[i].skeleton = get_string(strings, reader.getInt32());
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] & FLAG_TEXTURES) {
+            uint32_t texturesCount = reader.getInt32();
+            for (uint32_t j = 0; j < texturesCount; j++) {
+                const auto& slot = get_string(strings, reader.getInt32());
+                entities[i].textures[slot] =
+                    get_string(strings, reader.getInt32());
+            }
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] & FLAG_POSE) {
+            uint32_t posesCount = reader.getInt32();
+            auto& pose = entities[i].pose;
+            pose.reserve(std::min<size_t>(posesCount, reader.remaining()));
+            for (uint32_t j = 0; j < posesCount; j++) {
+                get_mat(reader, pose.emplace_back());
+            }
+        }
+    }
+    uint32_t componentsSize = reader.getInt32();
+    if (componentsSize > reader.remaining()) {
+        throw std::runtime_error("buffer underflow");
+    }
+    auto componentsRoot =
+        json::from_binary(reader.pointer(), componentsSize);
+    const auto& components = componentsRoot["data"];
+    if (components.size() != count) {
+        throw std::runtime_error("components count mismatch");
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        entities[i].components = components[i];
+    }
+    return entities;
+}
+
+std::vector<SavedEntity> entities_io::decode(const ubyte* src, size_t size) {
+    if (size >= 2 && src[0] == MAGIC) {
+        if (src[1] > VERSION) {
+            throw std::runtime_error(
+                "entities format " + std::to_string(src[1]) +
+                " is not supported"
+            );
+        }
+        auto body = gzip::decompress(src + 2, size - 2);
+        ByteReader reader(body.data(), body.size());
+        return decode_columns(reader);
+    }
+    dv::ArenaScope arena;
+    auto root = json::from_binary(src, size);
+    std::vector<SavedEntity> entities;
+    if (root.isObject() && root.has("data")) {
+        const auto& list = root["data"];
+        entities.reserve(list.size());
+        for (const auto& map : list) {
+            entities.push_back(from_value(map));
+        }
+    }
+    return entities;
+}
+
+SavedEntity entities_io::from_value(const dv::value& map) {
+    SavedEntity entity;
+    entity.def = map["def"].asString();
+    entity.uid = map["uid"].asInteger();
+    if (auto found = map.at(COMP_TRANSFORM)) {
+        const auto& tsfmap = *found;
+        dv::get_vec(tsfmap, "pos", entity.pos);
+        dv::get_vec(tsfmap, "size", entity.size);
+        dv::get_mat(tsfmap, "rot", entity.rot);
+    }
+    if (auto found = map.at(COMP_RIGIDBODY)) {
+        const auto& bodymap = *found;
+        bodymap.at("enabled").get(entity.bodyEnabled);
+        if (bodymap.has("vel")) {
+            dv::get_vec(bodymap, "vel", entity.velocity.emplace());
+        }
+        if (auto found = bodymap.at("damping")) {
+            entity.damping = (*found).asNumber();
+        }
+        std::string bodyTypeName;
+        bodymap.at("type").get(bodyTypeName);
+        entity.bodyType = BodyType_from(bodyTypeName);
+        bodymap.at("crouch").get(entity.crouching);
+    }
+    // skeleton name and skeleton component share the key
+    auto found = map.at(COMP_SKELETON);
+    if (found && (*found).isString()) {
+        entity.skeleton = (*found).asString();
+    } else if (found) {
+        const auto& skeletonmap = *found;
+        if (auto found = skeletonmap.at("textures")) {
+            for (const auto& [slot, texture] : (*found).asObject()) {
+                entity.textures[slot] = texture.asString();
+            }
+        }
+        if (auto found = skeletonmap.at("pose")) {
+            for (const auto& matrix : *found) {
+                dv::get_mat(matrix, entity.pose.emplace_back());
+            }
+        }
+    }
+    if (map.has("comps")) {
+        entity.components = map["comps"];
+    }
+    return entity;
+}
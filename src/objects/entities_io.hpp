@@ -0,0 +1,60 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "data/dv.hpp"
+#include "physics/Hitbox.hpp"
+#include "typedefs.hpp"
+
+/// @brief Entity state stored in the entities region layer
+struct SavedEntity {
+    std::string def;
+    entityid_t uid = 0;
+    glm::vec3 pos {};
+    glm::vec3 size {1.0f};
+    glm::mat3 rot {1.0f};
+    bool bodyEnabled = true;
+    std::optional<glm::vec3> velocity;
+    std::optional<float> damping;
+    std::optional<BodyType> bodyType;
+    bool crouching = false;
+    /// @brief Skeleton name if differs from the default one
+    std::string skeleton;
+    std::unordered_map<std::string, std::string> textures;
+    std::vector<glm::mat4> pose;
+    /// @brief Components SAVED_DATA tables by component name
+    dv::value components = nullptr;
+};
+
+/// @brief Entities region layer encoding.
+///
+/// Fixed components are stored as packed columns: def name index in
+/// the chunk strings table, uid, flags, position, then optional values
+/// of entities with the corresponding flag set. Only components script
+/// state is stored as binary json.
+///
+/// Legacy format (binary json {"data": [...]}) is still supported
+/// by decode.
+namespace entities_io {
+    /// @brief First byte of the columnar format. Legacy data starts with
+    /// a binary json document type or gzip magic
+    inline constexpr ubyte MAGIC = 0xEE;
+    inline constexpr ubyte VERSION = 1;
+
+    inline const std::string COMP_TRANSFORM = "transform";
+    inline const std::string COMP_RIGIDBODY = "rigidbody";
+    inline const std::string COMP_SKELETON = "skeleton";
+
+    std::vector<ubyte> encode(const std::vector<SavedEntity>& entities);
+
+    /// @brief Decode entities layer data of any supported format
+    /// @throws std::runtime_error - invalid or unsupported data
+    std::vector<SavedEntity> decode(const ubyte* src, size_t size);
+
+    /// @brief Read entity from legacy format map
+    SavedEntity from_value(const dv::value& map);
+}
@@ -1,6 +1,7 @@
 #include "PhysicsSolver.hpp"
 #include "Hitbox.hpp"
 
+#include "debug/Profiler.hpp"
 #include "maths/aabb.hpp"
 #include "voxels/Block.hpp"
 #include "voxels/Chunks.hpp"
@@ -24,6 +25,7 @@ void PhysicsSolver::step(
     uint substeps, 
     entityid_t entity
 ) {
+    PROFILE_SCOPE("physics.step");
     float dt = delta / static_cast<float>(substeps);
     float linearDamping = hitbox->linearDamping;
     float s = 2.0f/BLOCK_AABB_GRID;
@@ -40,6 +40,9 @@ struct ChunksSettings {
     IntegerSetting loadDistance {22, 3, 80};
     /// @brief Buffer zone where chunks are not unloading (chunk is unit)
     IntegerSetting padding {2, 1, 8};
+    /// @brief Spill generated chunk prototypes exceeding the memory budget
+    /// to world files. Files are not pruned and grow with explored area
+    FlagSetting prototypesSpill {false};
 };
 
 struct CameraSettings {
@@ -68,6 +71,8 @@ struct GraphicsSettings {
     IntegerSetting skyboxResolution {64 + 32, 64, 128};
     IntegerSetting chunkMaxVertices {200'000, 0, 4'000'000};
     IntegerSetting chunkMaxRenderers {6, -4, 32};
+    /// @brief Merge coplanar faces of full-cube blocks into larger quads
+    FlagSetting greedyMeshing {false};
 };
 
 struct DebugSettings {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdlib>
 #include <vector>
 #include <stdexcept>
 #include <functional>
@@ -7,6 +8,9 @@
 
 namespace util {
 
+    /// @brief 2D window of values moving over an infinite grid.
+    /// Buffer is addressed as a ring (toroidal): moving the window only
+    /// releases the rows and columns leaving it, other values stay in place
     template<class T, typename TCoord=int>
     class AreaMap2D {
     public:
@@ -14,43 +18,78 @@ namespace util {
     private:
         TCoord offsetX = 0, offsetY = 0;
         TCoord sizeX, sizeY;
-        std::vector<T> firstBuffer;
-        std::vector<T> secondBuffer;
+        /// @brief Buffer position of the window top-left corner
+        TCoord originX = 0, originY = 0;
+        std::vector<T> buffer;
         OutCallback outCallback;
 
         size_t valuesCount = 0;
-    
+
+        /// @brief Get buffer index of a position relative to the offset
+        size_t indexOf(TCoord lx, TCoord ly) const {
+            auto bx = lx + originX;
+            auto by = ly + originY;
+            if (bx >= sizeX) {
+                bx -= sizeX;
+            }
+            if (by >= sizeY) {
+                by -= sizeY;
+            }
+            return by * sizeX + bx;
+        }
+
+        static TCoord wrap(TCoord value, TCoord size) {
+            value %= size;
+            return value < 0 ? value + size : value;
+        }
+
+        void release(TCoord lx, TCoord ly) {
+            auto& element = buffer[indexOf(lx, ly)];
+            if (element == T{}) {
+                return;
+            }
+            T value = std::move(element);
+            element = T{};
+            valuesCount--;
+            if (outCallback) {
+                outCallback(lx + offsetX, ly + offsetY, value);
+            }
+        }
+
         void translate(TCoord dx, TCoord dy) {
             if (dx == 0 && dy == 0) {
                 return;
             }
-            std::fill(secondBuffer.begin(), secondBuffer.end(), T{});
-            for (TCoord y = 0; y < sizeY; y++) {
-                for (TCoord x = 0; x < sizeX; x++) {
-                    auto& value = firstBuffer[y * sizeX + x];
-                    auto nx = x - dx;
-                    auto ny = y - dy;
-                    if (value == T{}) {
-                        continue;
+            if (std::abs(dx) >= sizeX || std::abs(dy) >= sizeY) {
+                clear();
+            } else {
+                TCoord rowsBegin = dy > 0 ? 0 : sizeY + dy;
+                TCoord rowsEnd = dy > 0 ? dy : sizeY;
+                TCoord columnsBegin = dx > 0 ? 0 : sizeX + dx;
+                TCoord columnsEnd = dx > 0 ? dx : sizeX;
+                for (TCoord y = rowsBegin; y < rowsEnd; y++) {
+                    for (TCoord x = 0; x < sizeX; x++) {
+                        release(x, y);
                     }
-                    if (nx < 0 || ny < 0 || nx >= sizeX || ny >= sizeY) {
-                        if (outCallback) {
-                            outCallback(x + offsetX, y + offsetY, value);
-                        }
-                        valuesCount--;
+                }
+                for (TCoord y = 0; y < sizeY; y++) {
+                    if (y >= rowsBegin && y < rowsEnd) {
                         continue;
                     }
-                    secondBuffer[ny * sizeX + nx] = value;
+                    for (TCoord x = columnsBegin; x < columnsEnd; x++) {
+                        release(x, y);
+                    }
                 }
+                // released cells become the entering ones
+                originX = wrap(originX + dx, sizeX);
+                originY = wrap(originY + dy, sizeY);
             }
-            std::swap(firstBuffer, secondBuffer);
             offsetX += dx;
             offsetY += dy;
         }
     public:
         AreaMap2D(TCoord width, TCoord height)
-            : sizeX(width), sizeY(height), 
-              firstBuffer(width * height), secondBuffer(width * height) {
+            : sizeX(width), sizeY(height), buffer(width * height) {
         }
 
         const T* getIf(TCoord x, TCoord y) const {
@@ -59,7 +98,7 @@ namespace util {
             if (lx < 0 || ly < 0 || lx >= sizeX || ly >= sizeY) {
                 return nullptr;
             }
-            return &firstBuffer[ly * sizeX + lx];
+            return &buffer[indexOf(lx, ly)];
         }
 
         T get(TCoord x, TCoord y) const {
@@ -68,7 +107,7 @@ namespace util {
             if (lx < 0 || ly < 0 || lx >= sizeX || ly >= sizeY) {
                 return T{};
             }
-            return firstBuffer[ly * sizeX + lx];
+            return buffer[indexOf(lx, ly)];
         }
 
         T get(TCoord x, TCoord y, const T& def) const {
@@ -94,7 +133,7 @@ namespace util {
             if (lx < 0 || ly < 0 || lx >= sizeX || ly >= sizeY) {
                 throw std::invalid_argument("position is out of window");
             }
-            return firstBuffer[ly * sizeX + lx];
+            return buffer[indexOf(lx, ly)];
         }
 
         bool set(TCoord x, TCoord y, T value) {
@@ -103,7 +142,7 @@ namespace util {
             if (lx < 0 || ly < 0 || lx >= sizeX || ly >= sizeY) {
                 return false;
             }
-            auto& element = firstBuffer[ly * sizeX + lx];
+            auto& element = buffer[indexOf(lx, ly)];
             if (value && !element) {
                 valuesCount++;
             }
@@ -132,17 +171,18 @@ namespace util {
                 translate(0, delta);
             }
             const TCoord newVolume = newSizeX * newSizeY;
-            std::vector<T> newFirstBuffer(newVolume);
-            std::vector<T> newSecondBuffer(newVolume);
+            std::vector<T> newBuffer(newVolume);
             for (TCoord y = 0; y < sizeY && y < newSizeY; y++) {
                 for (TCoord x = 0; x < sizeX && x < newSizeX; x++) {
-                    newFirstBuffer[y * newSizeX + x] = firstBuffer[y * sizeX + x];
+                    newBuffer[y * newSizeX + x] =
+                        std::move(buffer[indexOf(x, y)]);
                 }
             }
             sizeX = newSizeX;
             sizeY = newSizeY;
-            firstBuffer = std::move(newFirstBuffer);
-            secondBuffer = std::move(newSecondBuffer);
+            originX = 0;
+            originY = 0;
+            buffer = std::move(newBuffer);
         }
 
         void setCenter(TCoord centerX, TCoord centerY) {
@@ -156,9 +196,9 @@ namespace util {
         void clear() {
             for (TCoord y = 0; y < sizeY; y++) {
                 for (TCoord x = 0; x < sizeX; x++) {
-                    auto i = y * sizeX + x;
-                    auto value = firstBuffer[i];
-                    firstBuffer[i] = {};
+                    auto& element = buffer[indexOf(x, y)];
+                    auto value = std::move(element);
+                    element = {};
                     if (outCallback && value != T {}) {
                         outCallback(x + offsetX, y + offsetY, value);
                     }
@@ -180,11 +220,15 @@ namespace util {
         }
 
         TCoord getHeight() const {
-            return sizeX;
+            return sizeY;
         }
 
-        const std::vector<T>& getBuffer() const {
-            return firstBuffer;
+        /// @brief Get value by row-major index relative to the offset
+        const T& operator[](size_t index) const {
+            return buffer[indexOf(
+                static_cast<TCoord>(index % sizeX),
+                static_cast<TCoord>(index / sizeX)
+            )];
         }
 
         size_t count() const {
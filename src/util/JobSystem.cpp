@@ -0,0 +1,203 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
+
+using namespace util;
+
+static debug::Logger logger("jobs");
+
+static thread_local const JobSystem* current_system = nullptr;
+static thread_local size_t current_worker = 0;
+
+JobGroup::JobGroup(JobSystem& system) : system(system) {
+}
+
+JobGroup::~JobGroup() {
+    wait();
+}
+
+void JobGroup::add(runnable job, JobPriority priority) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending++;
+    }
+    system.submit(
+        [this, job = std::move(job)]() {
+            try {
+                job();
+            } catch (...) {
+                finish();
+                throw;
+            }
+            finish();
+        },
+        priority
+    );
+}
+
+void JobGroup::finish() {
+    // group may be destroyed by a waiting thread right after unlock
+    JobSystem& system = this->system;
+    std::vector<Continuation> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            ready = std::move(continuations);
+            continuations.clear();
+        }
+        variable.notify_all();
+    }
+    for (auto& continuation : ready) {
+        system.submit(std::move(continuation.job), continuation.priority);
+    }
+}
+
+void JobGroup::then(runnable job, JobPriority priority) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending > 0) {
+            continuations.push_back(Continuation {std::move(job), priority});
+            return;
+        }
+    }
+    system.submit(std::move(job), priority);
+}
+
+void JobGroup::wait() {
+    using namespace std::chrono_literals;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (pending == 0) {
+                return;
+            }
+        }
+        if (!system.runPending()) {
+            std::unique_lock<std::mutex> lock(mutex);
+            variable.wait_for(lock, 1ms, [this] { return pending == 0; });
+        }
+    }
+}
+
+bool JobGroup::isDone() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending == 0;
+}
+
+JobSystem::JobSystem(uint numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(2U, std::thread::hardware_concurrency()) - 1;
+    }
+    for (uint i = 0; i < numThreads; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (uint i = 0; i < numThreads; i++) {
+        threads.emplace_back(&JobSystem::threadLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        working = false;
+    }
+    sleepVariable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void JobSystem::submit(runnable job, JobPriority priority) {
+    size_t index = current_system == this
+                       ? current_worker
+                       : nextQueue++ % queues.size();
+    auto& queue = *queues[index];
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs[static_cast<size_t>(priority)].push_back(std::move(job));
+    }
+    sleepVariable.notify_one();
+}
+
+bool JobSystem::takeJob(size_t index, runnable& job) {
+    size_t count = queues.size();
+    for (size_t priority = 0; priority < PRIORITIES; priority++) {
+        // own jobs are taken in submission order, other workers jobs are
+        // stolen from the back to not compete with owners
+        for (size_t i = 0; i < count; i++) {
+            auto& queue = *queues[(index + i) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& jobs = queue.jobs[priority];
+            if (jobs.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            } else {
+                job = std::move(jobs.back());
+                jobs.pop_back();
+            }
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::run(const runnable& job) {
+    try {
+        job();
+    } catch (const std::exception& err) {
+        logger.error() << "uncaught exception: " << err.what();
+    }
+}
+
+void JobSystem::threadLoop(size_t index) {
+    if constexpr (debug::profiler::is_enabled()) {
+        debug::profiler::set_thread_name("jobs-" + std::to_string(index));
+    }
+    current_system = this;
+    current_worker = index;
+    while (true) {
+        runnable job;
+        if (takeJob(index, job)) {
+            run(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepVariable.wait(lock, [this] { return queued > 0 || !working; });
+        if (!working && queued == 0) {
+            break;
+        }
+    }
+}
+
+bool JobSystem::runPending() {
+    runnable job;
+    size_t index = current_system == this ? current_worker : 0;
+    if (!takeJob(index, job)) {
+        return false;
+    }
+    run(job);
+    return true;
+}
+
+uint JobSystem::getThreadsCount() const {
+    return threads.size();
+}
+
+JobSystem& JobSystem::getDefault() {
+    static JobSystem system;
+    return system;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "delegates.hpp"
+#include "typedefs.hpp"
+
+namespace util {
+    enum class JobPriority { HIGH, NORMAL, LOW };
+
+    class JobSystem;
+
+    /// @brief Set of jobs with continuations performed when all jobs
+    /// of the group are done
+    class JobGroup {
+        struct Continuation {
+            runnable job;
+            JobPriority priority;
+        };
+        JobSystem& system;
+        std::mutex mutex;
+        std::condition_variable variable;
+        size_t pending = 0;
+        std::vector<Continuation> continuations;
+
+        void finish();
+    public:
+        JobGroup(JobSystem& system);
+        ~JobGroup();
+
+        /// @brief Submit job as part of the group
+        void add(runnable job, JobPriority priority = JobPriority::NORMAL);
+
+        /// @brief Submit job when all group jobs added before are done
+        /// (immediately if there is no unfinished jobs)
+        void then(runnable job, JobPriority priority = JobPriority::NORMAL);
+
+        /// @brief Wait until all group jobs are done. Calling thread
+        /// performs queued jobs while waiting
+        void wait();
+
+        bool isDone();
+    };
+
+    /// @brief Shared worker threads. Each worker has own jobs queues
+    /// (one per priority) and steals jobs from other workers when idle,
+    /// so subsystems share idle capacity instead of oversubscribing CPU
+    /// with own threads.
+    ///
+    /// Jobs submitted from a worker thread are queued to the same worker.
+    class JobSystem {
+        static constexpr size_t PRIORITIES = 3;
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<runnable> jobs[PRIORITIES];
+        };
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<size_t> queued = 0;
+        std::atomic<size_t> nextQueue = 0;
+        std::atomic<bool> working = true;
+        std::mutex sleepMutex;
+        std::condition_variable sleepVariable;
+
+        bool takeJob(size_t index, runnable& job);
+        void threadLoop(size_t index);
+        static void run(const runnable& job);
+    public:
+        /// @param numThreads number of worker threads
+        /// (0 - hardware concurrency except main thread)
+        JobSystem(uint numThreads = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+
+        void submit(runnable job, JobPriority priority = JobPriority::NORMAL);
+
+        /// @brief Perform one queued job in the calling thread
+        /// @return false if there is no queued jobs
+        bool runPending();
+
+        uint getThreadsCount() const;
+
+        /// @brief Get engine-wide job system
+        static JobSystem& getDefault();
+    };
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace util {
+    /// @brief Bounded lock-free queue for multiple producers and a single
+    /// consumer. Push fails instead of blocking when the queue is full.
+    /// Based on D. Vyukov bounded MPMC queue: each cell sequence number
+    /// tells if it's ready to be written or read at the current position
+    template <class T>
+    class RingQueue {
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+        alignas(64) std::atomic<size_t> writePos {0};
+        alignas(64) size_t readPos = 0;
+    public:
+        /// @param capacity max number of values, must be a power of two
+        RingQueue(size_t capacity)
+            : cells(std::make_unique<Cell[]>(capacity)), mask(capacity - 1) {
+            if (capacity < 2 || (capacity & mask)) {
+                throw std::invalid_argument("capacity must be a power of two");
+            }
+            for (size_t i = 0; i < capacity; i++) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /// @brief Thread-safe push
+        /// @return false if the queue is full (value is not moved)
+        bool push(T&& value) {
+            size_t pos = writePos.load(std::memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells[pos & mask];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) -
+                            static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (writePos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed
+                        )) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = writePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /// @brief Pop value. Must be called from the consumer thread only
+        /// @return false if the queue is empty
+        bool pop(T& dst) {
+            Cell& cell = cells[readPos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence != readPos + 1) {
+                return false;
+            }
+            dst = std::move(cell.value);
+            cell.sequence.store(readPos + mask + 1, std::memory_order_release);
+            readPos++;
+            return true;
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+    };
+}
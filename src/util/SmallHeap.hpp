@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <vector>
@@ -19,34 +20,70 @@ namespace util {
     /// small different structures
     /// @note alignment is not impemented 
     /// (impractical in the context of scripting and memory consumption)
+    /// 
+    /// Entries are stored as [index][size][data] records appended to a single
+    /// buffer and located with a sorted index, so find is O(log n) and
+    /// allocate/free do not shift entries data. Freed records are left as
+    /// garbage until it takes half of the buffer, then the buffer is
+    /// compacted. Serialized format is records sorted by index.
     /// @tparam Tindex entry index type
     /// @tparam Tsize entry size type
     template <typename Tindex, typename Tsize>
     class SmallHeap {
+        static constexpr size_t HEADER_SIZE = sizeof(Tindex) + sizeof(Tsize);
+
+        struct Entry {
+            Tindex index;
+            /// @brief entry data offset in the buffer
+            uint32_t offset;
+
+            bool operator<(Tindex other) const {
+                return index < other;
+            }
+        };
+
         std::vector<uint8_t> buffer;
-        Tindex entriesCount;
+        /// @brief entries sorted by index
+        std::vector<Entry> entries;
+        /// @brief number of bytes taken by freed records
+        size_t garbage = 0;
+        /// @brief buffer contains records sorted by index with no garbage
+        bool ordered = true;
+
+        typename std::vector<Entry>::iterator lowerBound(Tindex index) {
+            return std::lower_bound(entries.begin(), entries.end(), index);
+        }
+
+        void compact() {
+            std::vector<uint8_t> dst;
+            dst.reserve(buffer.size() - garbage);
+            for (auto& entry : entries) {
+                size_t recordSize = HEADER_SIZE + sizeAt(entry.offset);
+                auto src = buffer.data() + entry.offset - HEADER_SIZE;
+                entry.offset = dst.size() + HEADER_SIZE;
+                dst.insert(dst.end(), src, src + recordSize);
+            }
+            buffer = std::move(dst);
+            garbage = 0;
+            ordered = true;
+        }
+
+        Tsize sizeAt(size_t offset) const {
+            return read_int_le<Tsize>(buffer.data() + offset, -1);
+        }
     public:
-        SmallHeap() : entriesCount(0) {}
+        SmallHeap() = default;
 
         /// @brief Find current entry address by index
         /// @param index entry index
         /// @return temporary raw pointer or nullptr if entry does not exists
         /// @attention pointer becomes invalid after allocate(...) or free(...)
         uint8_t* find(Tindex index) {
-            auto data = buffer.data();
-            for (size_t i = 0; i < entriesCount; i++) {
-                auto nextIndex = read_int_le<Tindex>(data);
-                data += sizeof(Tindex);
-                auto nextSize = read_int_le<Tsize>(data);
-                data += sizeof(Tsize);
-                if (nextIndex == index) {
-                    return data;
-                } else if (nextIndex > index) {
-                    return nullptr;
-                }
-                data += nextSize;
+            auto found = lowerBound(index);
+            if (found == entries.end() || found->index != index) {
+                return nullptr;
             }
-            return nullptr;
+            return buffer.data() + found->offset;
         }
 
         /// @brief Erase entry from the heap
@@ -55,14 +92,19 @@ namespace util {
             if (ptr == nullptr) {
                 return;
             }
-            auto entrySize = sizeOf(ptr);
-            auto begin =
-                buffer.begin() +
-                ((ptr - sizeof(Tsize) - sizeof(Tindex)) - buffer.data());
-            buffer.erase(
-                begin, begin + entrySize + sizeof(Tsize) + sizeof(Tindex)
-            );
-            entriesCount--;
+            Tindex index = read_int_le<Tindex>(ptr - HEADER_SIZE);
+            auto found = lowerBound(index);
+            if (found == entries.end() || found->index != index) {
+                return;
+            }
+            garbage += HEADER_SIZE + sizeOf(ptr);
+            entries.erase(found);
+            ordered = false;
+            if (entries.empty()) {
+                buffer.clear();
+                garbage = 0;
+                ordered = true;
+            }
         }
 
         /// @brief Create or update entry (size)
@@ -80,7 +122,6 @@ namespace util {
             if (size == 0) {
                 throw std::invalid_argument("zero size");
             }
-            ptrdiff_t offset = 0;
             if (auto found = find(index)) {
                 auto entrySize = sizeOf(found);
                 if (size == entrySize) {
@@ -88,37 +129,34 @@ namespace util {
                     return found;
                 }
                 this->free(found);
-                return allocate(index, size);
             }
-            for (size_t i = 0; i < entriesCount; i++) {
-                auto data = buffer.data() + offset;
-                auto nextIndex = read_int_le<Tindex>(data);
-                data += sizeof(Tindex);
-                auto nextSize = read_int_le<Tsize>(data);
-                data += sizeof(Tsize);
-                if (nextIndex > index) {
-                    break;
-                }
-                data += nextSize;
-                offset = data - buffer.data();
+            if (garbage > buffer.size() / 2) {
+                compact();
             }
-            buffer.insert(
-                buffer.begin() + offset,
-                size + sizeof(Tindex) + sizeof(Tsize),
-                0
+            auto position = lowerBound(index);
+            if (position != entries.end()) {
+                ordered = false;
+            }
+            size_t offset = buffer.size() + HEADER_SIZE;
+            if (offset + size > std::numeric_limits<uint32_t>::max()) {
+                throw std::length_error("heap size limit exceeded");
+            }
+            buffer.resize(offset + size, 0);
+            entries.insert(
+                position, Entry {index, static_cast<uint32_t>(offset)}
             );
-            entriesCount++;
 
-            auto data = buffer.data() + offset;
+            auto data = buffer.data() + offset - HEADER_SIZE;
             *reinterpret_cast<Tindex*>(data) = dataio::h2le(index);
             data += sizeof(Tindex);
-            *reinterpret_cast<Tsize*>(data) = dataio::h2le(size);
+            *reinterpret_cast<Tsize*>(data) =
+                dataio::h2le(static_cast<Tsize>(size));
             return data + sizeof(Tsize);
         }
 
         /// @param ptr valid entry pointer
         /// @return entry size
-        Tsize sizeOf(uint8_t* ptr) const {
+        Tsize sizeOf(const uint8_t* ptr) const {
             if (ptr == nullptr) {
                 return 0;
             }
@@ -127,65 +165,102 @@ namespace util {
 
         /// @return number of entries
         Tindex count() const {
-            return entriesCount;
+            return entries.size();
         }
 
         /// @return total used bytes including entries metadata
         size_t size() const {
-            return buffer.size();
+            return buffer.size() - garbage;
         }
 
         inline bool operator==(const SmallHeap<Tindex, Tsize>& o) const {
-            if (o.entriesCount != entriesCount) {
+            if (o.entries.size() != entries.size()) {
                 return false;
             }
-            return buffer == o.buffer;
+            for (size_t i = 0; i < entries.size(); i++) {
+                const auto& a = entries[i];
+                const auto& b = o.entries[i];
+                Tsize size = sizeAt(a.offset);
+                if (a.index != b.index || size != o.sizeAt(b.offset) ||
+                    std::memcmp(
+                        buffer.data() + a.offset,
+                        o.buffer.data() + b.offset,
+                        size
+                    )) {
+                    return false;
+                }
+            }
+            return true;
         }
 
         util::Buffer<uint8_t> serialize() const {
-            util::Buffer<uint8_t> out(sizeof(Tindex) + buffer.size());
+            util::Buffer<uint8_t> out(sizeof(Tindex) + size());
             ubyte* dst = out.data();
-            const ubyte* src = buffer.data();
 
-            *reinterpret_cast<Tindex*>(dst) = dataio::h2le(entriesCount);
+            *reinterpret_cast<Tindex*>(dst) = dataio::h2le(count());
             dst += sizeof(Tindex);
 
-            std::memcpy(dst, src, buffer.size());
+            if (ordered) {
+                std::memcpy(dst, buffer.data(), buffer.size());
+                return out;
+            }
+            for (const auto& entry : entries) {
+                size_t recordSize = HEADER_SIZE + sizeAt(entry.offset);
+                std::memcpy(
+                    dst, buffer.data() + entry.offset - HEADER_SIZE, recordSize
+                );
+                dst += recordSize;
+            }
             return out;
         }
 
         void deserialize(const ubyte* src, size_t size) {
-            entriesCount = read_int_le<Tindex>(src);
+            Tindex entriesCount = read_int_le<Tindex>(src);
             buffer.resize(size - sizeof(Tindex));
             std::memcpy(buffer.data(), src + sizeof(Tindex), buffer.size());
+
+            entries.clear();
+            entries.reserve(entriesCount);
+            size_t offset = 0;
+            for (size_t i = 0; i < entriesCount; i++) {
+                auto index = read_int_le<Tindex>(buffer.data() + offset);
+                offset += HEADER_SIZE;
+                entries.push_back(
+                    Entry {index, static_cast<uint32_t>(offset)}
+                );
+                offset += sizeAt(offset);
+            }
+            garbage = 0;
+            ordered = true;
         }
 
         struct const_iterator {
         private:
-            const std::vector<uint8_t>& buffer;
+            const SmallHeap& heap;
+            size_t position;
         public:
             Tindex index;
-            size_t offset;
 
-            const_iterator(
-                const std::vector<uint8_t>& buffer, Tindex index, size_t offset
-            ) : buffer(buffer), index(index), offset(offset) {}
+            const_iterator(const SmallHeap& heap, size_t position)
+                : heap(heap), position(position), index(0) {
+                if (position < heap.entries.size()) {
+                    index = heap.entries[position].index;
+                }
+            }
 
             Tsize size() const {
-                return read_int_le<Tsize>(buffer.data() + offset, -1);
+                return heap.sizeAt(heap.entries[position].offset);
             }
 
             bool operator!=(const const_iterator& o) const {
-                return o.offset != offset;
+                return o.position != position;
             }
 
             const_iterator& operator++() {
-                offset += size();
-                if (offset == buffer.size()) {
-                    return *this;
+                position++;
+                if (position < heap.entries.size()) {
+                    index = heap.entries[position].index;
                 }
-                index = read_int_le<Tindex>(buffer.data() + offset);
-                offset += sizeof(Tindex) + sizeof(Tsize);
                 return *this;
             }
 
@@ -194,22 +269,16 @@ namespace util {
             }
 
             const uint8_t* data() const {
-                return buffer.data() + offset;
+                return heap.buffer.data() + heap.entries[position].offset;
             }
         };
 
         const_iterator begin() const {
-            if (buffer.empty()) {
-                return end();
-            }
-            return const_iterator (
-                buffer,
-                read_int_le<Tindex>(buffer.data()),
-                sizeof(Tindex) + sizeof(Tsize));
+            return const_iterator(*this, 0);
         }
 
         const_iterator end() const {
-            return const_iterator (buffer, 0, buffer.size());
+            return const_iterator(*this, entries.size());
         }
     };
 }
@@ -1,29 +1,25 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "debug/Logger.hpp"
 #include "delegates.hpp"
 #include "interfaces/Task.hpp"
+#include "JobSystem.hpp"
 
 namespace util {
 
-    template <class J, class T>
-    struct ThreadPoolResult {
-        J job;
-        std::condition_variable& variable;
-        int workerIndex;
-        bool& locked;
-        T entry;
-    };
-
     template <class T, class R>
     class Worker {
     public:
@@ -32,16 +28,33 @@ namespace util {
         virtual R operator()(const T&) = 0;
     };
 
+    /// @brief Jobs queue performed by workers in the engine-wide job system
+    /// threads. Number of workers limits jobs of the pool in work at once,
+    /// each worker object is used by one job at time. Results are passed to
+    /// the consumer in update() called from the main thread
     template <class T, class R>
     class ThreadPool : public Task {
+        using WorkerPtr = std::shared_ptr<Worker<T, R>>;
+
+        struct Result {
+            T job;
+            R entry;
+            /// @brief Worker released after result is consumed
+            /// (if results are not standalone)
+            WorkerPtr worker;
+        };
+
+        std::string name;
         debug::Logger logger;
-        std::queue<T> jobs;
-        std::queue<ThreadPoolResult<T, R>> results;
+        JobSystem& jobSystem;
+        JobPriority priority = JobPriority::NORMAL;
+        std::deque<T> jobs;
+        std::vector<WorkerPtr> freeWorkers;
+        size_t workersCount;
+        std::queue<Result> results;
         std::mutex resultsMutex;
-        std::vector<std::thread> threads;
-        std::condition_variable jobsMutexCondition;
+        std::condition_variable idleCondition;
         std::mutex jobsMutex;
-        std::vector<std::unique_lock<std::mutex>> workersBlocked;
         consumer<R&> resultConsumer;
         consumer<T&> onJobFailed = nullptr;
         runnable onComplete = nullptr;
@@ -52,55 +65,63 @@ namespace util {
         bool standaloneResults = true;
         bool stopOnFail = true;
 
-        void threadLoop(int index, std::shared_ptr<Worker<T, R>> worker) {
-            std::condition_variable variable;
-            std::mutex mutex;
-            bool locked = false;
-            while (working) {
-                T job;
-                {
-                    std::unique_lock<std::mutex> lock(jobsMutex);
-                    jobsMutexCondition.wait(lock, [this] {
-                        return !jobs.empty() || !working;
-                    });
-                    if (!working || failed) {
-                        break;
-                    }
-                    job = std::move(jobs.front());
-                    jobs.pop();
+        /// @brief Submit queued jobs to the job system while there are
+        /// free workers
+        void dispatch() {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            while (working && !failed && !jobs.empty() &&
+                   !freeWorkers.empty()) {
+                auto worker = std::move(freeWorkers.back());
+                freeWorkers.pop_back();
+                T job = std::move(jobs.front());
+                jobs.pop_front();
+                busyWorkers++;
+                jobSystem.submit(
+                    [this, worker, job = std::move(job)]() mutable {
+                        perform(std::move(worker), std::move(job));
+                    },
+                    priority
+                );
+            }
+        }
+
+        void releaseWorker(WorkerPtr worker) {
+            {
+                std::lock_guard<std::mutex> lock(jobsMutex);
+                freeWorkers.push_back(std::move(worker));
+            }
+            dispatch();
+        }
 
-                    busyWorkers++;
+        void perform(WorkerPtr worker, T job) {
+            std::optional<R> result;
+            try {
+                result = (*worker)(job);
+            } catch (std::exception& err) {
+                if (onJobFailed) {
+                    onJobFailed(job);
                 }
-                try {
-                    R result = (*worker)(job);
-                    {
-                        std::lock_guard<std::mutex> lock(resultsMutex);
-                        results.push(ThreadPoolResult<T, R> {
-                            job, variable, index, locked, result});
-                        if (!standaloneResults) {
-                            locked = true;
-                        }
-                        busyWorkers--;
-                    }
-                    if (!standaloneResults) {
-                        std::unique_lock<std::mutex> lock(mutex);
-                        variable.wait(lock, [&] {
-                            return !working || !locked;
-                        });
-                    }
-                } catch (std::exception& err) {
-                    busyWorkers--;
-                    if (onJobFailed) {
-                        onJobFailed(job);
-                    }
-                    if (stopOnFail) {
-                        std::lock_guard<std::mutex> lock(jobsMutex);
-                        failed = true;
-                    }
-                    logger.error() << "uncaught exception: " << err.what();
+                if (stopOnFail) {
+                    std::lock_guard<std::mutex> lock(jobsMutex);
+                    failed = true;
                 }
-                jobsDone++;
+                logger.error() << "uncaught exception: " << err.what();
             }
+            bool keepWorker = result && !standaloneResults;
+            if (!keepWorker) {
+                releaseWorker(worker);
+            }
+            // pool may be destroyed right after this block
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            if (result) {
+                results.push(Result {
+                    std::move(job),
+                    std::move(*result),
+                    keepWorker ? std::move(worker) : nullptr});
+            }
+            jobsDone++;
+            busyWorkers--;
+            idleCondition.notify_all();
         }
     public:
         static constexpr int UNLIMITED = 0;
@@ -113,35 +134,38 @@ namespace util {
         /// @param resultConsumer workers results consumer function
         /// @param maxWorkers max number of workers. Special values: 0 is 
         /// unlimited, -2 is half of auto count, -4 is quarter.
+        /// @param jobSystem job system performing jobs
         ThreadPool(
             std::string name,
             supplier<std::shared_ptr<Worker<T, R>>> workersSupplier,
             consumer<R&> resultConsumer,
-            int maxWorkers=UNLIMITED
+            int maxWorkers=UNLIMITED,
+            JobSystem& jobSystem=JobSystem::getDefault()
         )
-            : logger(std::move(name)), resultConsumer(resultConsumer) {
-            uint numThreads = std::thread::hardware_concurrency();
+            : name(std::move(name)),
+              logger(this->name),
+              jobSystem(jobSystem),
+              resultConsumer(resultConsumer) {
+            uint numWorkers = jobSystem.getThreadsCount();
             switch (maxWorkers) {
                 case UNLIMITED:
                     break;
                 case HALF:
-                    numThreads = std::max(1U, numThreads);
+                    numWorkers = std::max(1U, numWorkers / 2);
                     break;
                 case QUARTER:
-                    numThreads = std::max(1U, numThreads / 4);
+                    numWorkers = std::max(1U, numWorkers / 4);
                     break;
                 default:
-                    numThreads = std::max(
-                        1U, std::min(numThreads, static_cast<uint>(maxWorkers))
+                    numWorkers = std::max(
+                        1U, std::min(numWorkers, static_cast<uint>(maxWorkers))
                     );
                     break;
             }
-            for (uint i = 0; i < numThreads; i++) {
-                threads.emplace_back(
-                    &ThreadPool<T, R>::threadLoop, this, i, workersSupplier()
-                );
-                workersBlocked.emplace_back();
+            for (uint i = 0; i < numWorkers; i++) {
+                freeWorkers.push_back(workersSupplier());
             }
+            workersCount = numWorkers;
         }
         ~ThreadPool() {
             terminate();
@@ -151,6 +175,7 @@ namespace util {
             return working;
         }
 
+        /// @brief Cancel queued jobs and wait for jobs in work
         void terminate() override {
             if (!working) {
                 return;
@@ -158,23 +183,11 @@ namespace util {
             {
                 std::lock_guard<std::mutex> lock(jobsMutex);
                 working = false;
+                jobs.clear();
             }
-            {
-                std::lock_guard<std::mutex> lock(resultsMutex);
-                while (!results.empty()) {
-                    ThreadPoolResult<T, R> entry = results.front();
-                    results.pop();
-                    if (!standaloneResults) {
-                        entry.locked = false;
-                        entry.variable.notify_all();
-                    }
-                }
-            }
-
-            jobsMutexCondition.notify_all();
-            for (auto& thread : threads) {
-                thread.join();
-            }
+            std::unique_lock<std::mutex> lock(resultsMutex);
+            idleCondition.wait(lock, [this] { return busyWorkers == 0; });
+            results = {};
         }
 
         void update() override {
@@ -186,12 +199,16 @@ namespace util {
             }
 
             bool complete = false;
+            std::vector<WorkerPtr> consumedWorkers;
             {
                 std::lock_guard<std::mutex> lock(resultsMutex);
                 while (!results.empty()) {
-                    ThreadPoolResult<T, R> entry = results.front();
+                    Result entry = std::move(results.front());
                     results.pop();
 
+                    if (entry.worker) {
+                        consumedWorkers.push_back(std::move(entry.worker));
+                    }
                     try {
                         resultConsumer(entry.entry);
                     } catch (std::exception& err) {
@@ -206,14 +223,10 @@ namespace util {
                         }
                         break;
                     }
-
-                    if (!standaloneResults) {
-                        entry.locked = false;
-                        entry.variable.notify_all();
-                    }
                 }
 
-                if (onComplete && busyWorkers == 0) {
+                if (onComplete && busyWorkers == 0 && results.empty() &&
+                    consumedWorkers.empty()) {
                     std::lock_guard<std::mutex> jobsLock(jobsMutex);
                     if (jobs.empty()) {
                         onComplete();
@@ -221,6 +234,9 @@ namespace util {
                     }
                 }
             }
+            for (auto& worker : consumedWorkers) {
+                releaseWorker(std::move(worker));
+            }
             if (failed) {
                 throw std::runtime_error("some job failed");
             }
@@ -232,9 +248,9 @@ namespace util {
         void enqueueJob(T job) {
             {
                 std::lock_guard<std::mutex> lock(jobsMutex);
-                jobs.push(std::move(job));
+                jobs.push_back(std::move(job));
             }
-            jobsMutexCondition.notify_one();
+            dispatch();
         }
 
         void clearQueue() {
@@ -242,11 +258,70 @@ namespace util {
             jobs = {};
         }
 
-        /// @brief If false: worker will be blocked until it's result performed
+        /// @brief Remove queued (not taken by workers yet) jobs matching
+        /// the predicate
+        /// @param predicate called for each queued job in locked state
+        /// @param callback called for each removed job after unlock
+        /// @return number of removed jobs
+        template <class Predicate>
+        size_t removeJobs(
+            const Predicate& predicate, const consumer<T&>& callback = nullptr
+        ) {
+            std::vector<T> removed;
+            {
+                std::lock_guard<std::mutex> lock(jobsMutex);
+                auto it = std::stable_partition(
+                    jobs.begin(), jobs.end(), [&predicate](const T& job) {
+                        return !predicate(job);
+                    }
+                );
+                std::move(it, jobs.end(), std::back_inserter(removed));
+                jobs.erase(it, jobs.end());
+            }
+            if (callback) {
+                for (auto& job : removed) {
+                    callback(job);
+                }
+            }
+            return removed.size();
+        }
+
+        /// @brief Reorder queued jobs. Jobs with lesser key are taken first
+        /// @param keyFunc job sort key function, called once per job
+        template <class KeyFunc>
+        void sortJobs(const KeyFunc& keyFunc) {
+            using Key = decltype(keyFunc(std::declval<const T&>()));
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            if (jobs.size() < 2) {
+                return;
+            }
+            std::vector<std::pair<Key, T>> entries;
+            entries.reserve(jobs.size());
+            for (auto& job : jobs) {
+                entries.emplace_back(keyFunc(job), std::move(job));
+            }
+            std::stable_sort(
+                entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+                    return a.first < b.first;
+                }
+            );
+            jobs.clear();
+            for (auto& entry : entries) {
+                jobs.push_back(std::move(entry.second));
+            }
+        }
+
+        /// @brief If false: worker will not take next job until it's result
+        /// performed
         void setStandaloneResults(bool flag) {
             standaloneResults = flag;
         }
 
+        /// @brief Set priority of the pool jobs in the job system
+        void setPriority(JobPriority priority) {
+            this->priority = priority;
+        }
+
         void setStopOnFail(bool flag) {
             stopOnFail = flag;
         }
@@ -280,7 +355,7 @@ namespace util {
         }
 
         uint getWorkersCount() const {
-            return threads.size();
+            return workersCount;
         }
     };
 
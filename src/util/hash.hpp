@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include "typedefs.hpp"
+
+namespace util {
+    /// @brief Incremental 64 bit FNV-1a hash. Not cryptographic, used to
+    /// detect changes of cached data sources
+    class Hasher64 {
+        uint64_t state = OFFSET_BASIS;
+    public:
+        static constexpr uint64_t OFFSET_BASIS = 0xcbf29ce484222325ULL;
+        static constexpr uint64_t PRIME = 0x100000001b3ULL;
+
+        void update(const void* data, size_t size) {
+            auto bytes = static_cast<const ubyte*>(data);
+            for (size_t i = 0; i < size; i++) {
+                state ^= bytes[i];
+                state *= PRIME;
+            }
+        }
+
+        /// @brief Hash string with its length, so sequences of strings
+        /// are not ambiguous
+        void update(const std::string& str) {
+            update(static_cast<uint64_t>(str.length()));
+            update(str.data(), str.length());
+        }
+
+        void update(uint64_t value) {
+            ubyte bytes[sizeof(uint64_t)];
+            for (size_t i = 0; i < sizeof(uint64_t); i++) {
+                bytes[i] = static_cast<ubyte>(value >> (i * 8));
+            }
+            update(bytes, sizeof(bytes));
+        }
+
+        uint64_t value() const {
+            return state;
+        }
+    };
+}
@@ -11,7 +11,7 @@
 static debug::Logger logger("main");
 
 int main(int argc, char** argv) {
-    debug::Logger::init("latest.log");
+    debug::Logger::init("latest.log", true);
 
     EnginePaths paths;
     if (!parse_cmdline(argc, argv, paths))
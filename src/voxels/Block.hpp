@@ -42,6 +42,7 @@ struct block_funcs_set {
     bool oninteract : 1;
     bool randupdate : 1;
     bool onblockstick : 1;
+    bool randupdatebatch : 1;
 };
 
 struct CoordSystem {
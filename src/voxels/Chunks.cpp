@@ -404,7 +404,8 @@ void Chunks::set(
     const auto& newdef = indices->blocks.require(id);
     vox.id = id;
     vox.state = state;
-    chunk->setModifiedAndUnsaved();
+    chunk->flags.unsaved = true;
+    markModified(*chunk, lx, lz);
     if (!state.segment && newdef.rt.extended) {
         repairSegments(newdef, state, x, y, z);
     }
@@ -415,18 +416,27 @@ void Chunks::set(
         chunk->top = y + 1;
     else if (id == 0)
         chunk->updateHeights();
+}
+
+void Chunks::markModified(Chunk& chunk, int lx, int lz) const {
+    chunk.flags.modified = true;
 
-    if (lx == 0 && (chunk = getChunk(cx - 1, cz))) {
-        chunk->flags.modified = true;
+    // meshes use one voxel wide border of neighbour chunks
+    int dx = lx == 0 ? -1 : (lx == CHUNK_W - 1 ? 1 : 0);
+    int dz = lz == 0 ? -1 : (lz == CHUNK_D - 1 ? 1 : 0);
+    if (dx == 0 && dz == 0) {
+        return;
     }
-    if (lz == 0 && (chunk = getChunk(cx, cz - 1))) {
-        chunk->flags.modified = true;
+    Chunk* neighbour;
+    if (dx && (neighbour = getChunk(chunk.x + dx, chunk.z))) {
+        neighbour->flags.modified = true;
     }
-    if (lx == CHUNK_W - 1 && (chunk = getChunk(cx, cz))) {
-        chunk->flags.modified = true;
+    if (dz && (neighbour = getChunk(chunk.x, chunk.z + dz))) {
+        neighbour->flags.modified = true;
     }
-    if (lz == CHUNK_D - 1 && (chunk = getChunk(cx, cz + 1))) {
-        chunk->flags.modified = true;
+    // corner voxels affect diagonal neighbour ambient occlusion
+    if (dx && dz && (neighbour = getChunk(chunk.x + dx, chunk.z + dz))) {
+        neighbour->flags.modified = true;
     }
 }
 
@@ -664,6 +674,165 @@ glm::vec3 Chunks::rayCastToObstacle(
     return glm::vec3(px + maxDist * dx, py + maxDist * dy, pz + maxDist * dz);
 }
 
+void Chunks::getVoxels(
+    const glm::ivec3& start,
+    const glm::ivec3& size,
+    voxel* voxels,
+    light_t* lights
+) const {
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0) {
+        return;
+    }
+    auto end = start + size;
+    int scx = floordiv(start.x, CHUNK_W);
+    int scz = floordiv(start.z, CHUNK_D);
+    int ecx = floordiv(end.x - 1, CHUNK_W);
+    int ecz = floordiv(end.z - 1, CHUNK_D);
+
+    for (int cz = scz; cz <= ecz; cz++) {
+        int z0 = std::max(start.z, cz * CHUNK_D);
+        int z1 = std::min(end.z, (cz + 1) * CHUNK_D);
+        for (int cx = scx; cx <= ecx; cx++) {
+            int x0 = std::max(start.x, cx * CHUNK_W);
+            int x1 = std::min(end.x, (cx + 1) * CHUNK_W);
+            int length = x1 - x0;
+
+            const Chunk* chunk = getChunk(cx, cz);
+            for (int y = start.y; y < end.y; y++) {
+                for (int z = z0; z < z1; z++) {
+                    size_t dst = vox_index(
+                        x0 - start.x, y - start.y, z - start.z, size.x, size.z
+                    );
+                    if (chunk == nullptr || y < 0 || y >= CHUNK_H) {
+                        std::fill_n(voxels + dst, length, voxel {BLOCK_VOID, {}});
+                        if (lights) {
+                            std::fill_n(lights + dst, length, 0);
+                        }
+                        continue;
+                    }
+                    size_t src = vox_index(x0 - cx * CHUNK_W, y, z - cz * CHUNK_D);
+                    std::copy_n(chunk->voxels + src, length, voxels + dst);
+                    if (lights) {
+                        std::copy_n(
+                            chunk->lightmap.getLights() + src, length, lights + dst
+                        );
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Chunks::addSegments(
+    const Block& def,
+    blockstate state,
+    const glm::ivec3& origin,
+    std::vector<glm::ivec3>& dst
+) const {
+    const auto& rotation = def.rotations.variants[state.rotation];
+    for (int sy = 0; sy < def.size.y; sy++) {
+        for (int sz = 0; sz < def.size.z; sz++) {
+            for (int sx = 0; sx < def.size.x; sx++) {
+                if ((sx | sy | sz) == 0) {
+                    continue;
+                }
+                glm::ivec3 pos = origin;
+                pos += rotation.axisX * sx;
+                pos += rotation.axisY * sy;
+                pos += rotation.axisZ * sz;
+                if (get(pos.x, pos.y, pos.z)) {
+                    dst.push_back(pos);
+                }
+            }
+        }
+    }
+}
+
+void Chunks::setVoxels(
+    const glm::ivec3& start,
+    const glm::ivec3& size,
+    const voxel* voxels,
+    std::vector<glm::ivec3>& changed
+) {
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0) {
+        return;
+    }
+    auto end = start + size;
+    int y0 = std::max(start.y, 0);
+    int y1 = std::min(end.y, CHUNK_H);
+    int scx = floordiv(start.x, CHUNK_W);
+    int scz = floordiv(start.z, CHUNK_D);
+    int ecx = floordiv(end.x - 1, CHUNK_W);
+    int ecz = floordiv(end.z - 1, CHUNK_D);
+
+    for (int cz = scz; cz <= ecz; cz++) {
+        int z0 = std::max(start.z, cz * CHUNK_D);
+        int z1 = std::min(end.z, (cz + 1) * CHUNK_D);
+        for (int cx = scx; cx <= ecx; cx++) {
+            Chunk* chunk = getChunk(cx, cz);
+            if (chunk == nullptr) {
+                continue;
+            }
+            int x0 = std::max(start.x, cx * CHUNK_W);
+            int x1 = std::min(end.x, (cx + 1) * CHUNK_W);
+            bool chunkChanged = false;
+            for (int y = y0; y < y1; y++) {
+                for (int z = z0; z < z1; z++) {
+                    int lz = z - cz * CHUNK_D;
+                    for (int x = x0; x < x1; x++) {
+                        int lx = x - cx * CHUNK_W;
+                        const voxel& src = voxels[vox_index(
+                            x - start.x, y - start.y, z - start.z, size.x, size.z
+                        )];
+                        voxel& vox = chunk->voxels[vox_index(lx, y, lz)];
+                        if (src.id == BLOCK_VOID || (vox.id == src.id &&
+                            blockstate2int(vox.state) ==
+                                blockstate2int(src.state))) {
+                            continue;
+                        }
+                        changed.emplace_back(x, y, z);
+
+                        const auto& prevdef = indices->blocks.require(vox.id);
+                        const auto& newdef = indices->blocks.require(src.id);
+                        // blocks requiring finalization or initialization
+                        if (prevdef.inventorySize || prevdef.dataStruct ||
+                            prevdef.rt.extended || newdef.rt.extended) {
+                            // segments erased and placed by set
+                            if (prevdef.rt.extended && !vox.state.segment) {
+                                addSegments(
+                                    prevdef, vox.state, {x, y, z}, changed
+                                );
+                            }
+                            if (newdef.rt.extended && !src.state.segment) {
+                                addSegments(
+                                    newdef, src.state, {x, y, z}, changed
+                                );
+                            }
+                            set(x, y, z, src.id, src.state);
+                            continue;
+                        }
+                        if (!chunk->inventories.empty()) {
+                            chunk->removeBlockInventory(lx, y, lz);
+                        }
+                        vox = src;
+                        chunkChanged = true;
+                    }
+                }
+            }
+            if (!chunkChanged) {
+                continue;
+            }
+            chunk->flags.unsaved = true;
+            // mark neighbours sharing borders with the changed area
+            markModified(*chunk, x0 - cx * CHUNK_W, z0 - cz * CHUNK_D);
+            markModified(*chunk, x1 - 1 - cx * CHUNK_W, z1 - 1 - cz * CHUNK_D);
+            markModified(*chunk, x0 - cx * CHUNK_W, z1 - 1 - cz * CHUNK_D);
+            markModified(*chunk, x1 - 1 - cx * CHUNK_W, z0 - cz * CHUNK_D);
+            chunk->updateHeights();
+        }
+    }
+}
+
 void Chunks::setCenter(int32_t x, int32_t z) {
     areaMap.setCenter(floordiv(x, CHUNK_W), floordiv(z, CHUNK_D));
 }
@@ -778,24 +947,23 @@ void Chunks::save(Chunk* chunk) {
             )
         );
         auto entities = level->entities->getAllInside(aabb);
-        auto root = dv::object();
-        root["data"] = level->entities->serialize(entities);
         if (!entities.empty()) {
-            level->entities->despawn(std::move(entities));
             chunk->flags.entities = true;
         }
-        worldFiles->getRegions().put(
-            chunk,
-            chunk->flags.entities ? json::to_binary(root, true)
-                                  : std::vector<ubyte>()
-        );
+        std::vector<ubyte> entitiesData;
+        if (chunk->flags.entities) {
+            entitiesData = level->entities->serialize(entities);
+        }
+        if (!entities.empty()) {
+            level->entities->despawn(std::move(entities));
+        }
+        worldFiles->getRegions().put(chunk, std::move(entitiesData));
     }
 }
 
 void Chunks::saveAll() {
-    const auto& chunks = areaMap.getBuffer();
     for (size_t i = 0; i < areaMap.area(); i++) {
-        if (auto& chunk = chunks[i]) {
+        if (auto& chunk = areaMap[i]) {
             save(chunk.get());
         }
     }
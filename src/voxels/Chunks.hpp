@@ -32,6 +32,14 @@ class Chunks {
     void repairSegments(
         const Block& def, blockstate state, int x, int y, int z
     );
+    /// @brief Append positions of extended block segments in loaded chunks
+    /// (origin excluded)
+    void addSegments(
+        const Block& def,
+        blockstate state,
+        const glm::ivec3& origin,
+        std::vector<glm::ivec3>& dst
+    ) const;
     void setRotationExtended(
         const Block& def,
         blockstate state,
@@ -71,6 +79,13 @@ public:
     ubyte getLight(int32_t x, int32_t y, int32_t z, int channel) const;
     void set(int32_t x, int32_t y, int32_t z, uint32_t id, blockstate state);
 
+    /// @brief Mark chunk as modified (mesh rebuild required) with neighbour
+    /// chunks which meshes depend on the voxel (if it is on a chunk border)
+    /// @param chunk chunk containing the voxel
+    /// @param lx voxel x position in the chunk
+    /// @param lz voxel z position in the chunk
+    void markModified(Chunk& chunk, int lx, int lz) const;
+
     /// @brief Seek for the extended block origin position
     /// @param pos segment block position
     /// @param def segment block definition
@@ -120,6 +135,32 @@ public:
 
     void getVoxels(VoxelsVolume* volume, bool backlight = false) const;
 
+    /// @brief Copy voxels of the box chunk-wise. Voxels of missing chunks
+    /// or out of height range are filled with BLOCK_VOID
+    /// @param start box start position
+    /// @param size box size
+    /// @param voxels destination voxels buffer indexed with vox_index
+    /// @param lights optional destination lights buffer
+    void getVoxels(
+        const glm::ivec3& start,
+        const glm::ivec3& size,
+        voxel* voxels,
+        light_t* lights = nullptr
+    ) const;
+
+    /// @brief Write voxels to the box chunk-wise. Voxels with BLOCK_VOID
+    /// id and voxels of missing chunks are skipped. Lights are not updated
+    /// @param start box start position
+    /// @param size box size
+    /// @param voxels source voxels buffer indexed with vox_index
+    /// @param changed positions of changed voxels are appended to
+    void setVoxels(
+        const glm::ivec3& start,
+        const glm::ivec3& size,
+        const voxel* voxels,
+        std::vector<glm::ivec3>& changed
+    );
+
     void setCenter(int32_t x, int32_t z);
     void resize(uint32_t newW, uint32_t newD);
 
@@ -127,8 +168,10 @@ public:
     void save(Chunk* chunk);
     void saveAll();
 
-    const std::vector<std::shared_ptr<Chunk>>& getChunks() const {
-        return areaMap.getBuffer();
+    /// @brief Get chunks area. Chunks are accessed by row-major index
+    /// relative to the area offset
+    const util::AreaMap2D<std::shared_ptr<Chunk>, int32_t>& getChunks() const {
+        return areaMap;
     }
 
     int getWidth() const {
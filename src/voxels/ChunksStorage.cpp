@@ -9,6 +9,7 @@
 #include "lighting/Lightmap.hpp"
 #include "maths/voxmaths.hpp"
 #include "objects/Entities.hpp"
+#include "objects/entities_io.hpp"
 #include "typedefs.hpp"
 #include "world/Level.hpp"
 #include "world/World.hpp"
@@ -64,9 +65,8 @@ std::shared_ptr<Chunk> ChunksStorage::create(int x, int z) {
         auto invs = regions.fetchInventories(chunk->x, chunk->z);
         chunk->setBlockInventories(std::move(invs));
 
-        auto entitiesData = regions.fetchEntities(chunk->x, chunk->z);
-        if (entitiesData.getType() == dv::value_type::object) {
-            level->entities->loadEntities(std::move(entitiesData));
+        if (auto entities = regions.fetchEntities(chunk->x, chunk->z)) {
+            level->entities->loadEntities(*entities);
             chunk->flags.entities = true;
         }
 
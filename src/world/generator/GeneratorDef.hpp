@@ -200,6 +200,9 @@ struct GeneratorDef {
 
     std::unique_ptr<GeneratorScript> script;
 
+    /// @brief Hash of the generator script source
+    uint64_t scriptHash = 0;
+
     /// @brief Sea level (top of seaLayers)
     uint seaLevel = 0;
 
@@ -0,0 +1,448 @@
+#include "PrototypesCache.hpp"
+
+#include <map>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+
+#include "coders/byte_utils.hpp"
+#include "files/files.hpp"
+#include "maths/voxmaths.hpp"
+#include "debug/Logger.hpp"
+
+static debug::Logger logger("prototypes-cache");
+
+static const char MAGIC[] = "VEPROTO";
+static constexpr size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+
+enum CachedPrototypeFlags : ubyte {
+    FLAG_WIDE_STRUCTS = 1,
+    FLAG_BIOMES = 2,
+    FLAG_HEIGHTS = 4,
+    FLAG_STRUCTURES = 8,
+};
+
+size_t CachedPrototype::memoryUsage() const {
+    size_t size = sizeof(CachedPrototype);
+    size += biomes.capacity() * sizeof(uint16_t);
+    size += heights.capacity() * sizeof(float);
+    if (wideStructs) {
+        size += wideStructs->capacity() * sizeof(Placement);
+    }
+    if (structures) {
+        size += structures->capacity() * sizeof(Placement);
+    }
+    return size;
+}
+
+static void write_ivec3(ByteBuilder& builder, const glm::ivec3& vec) {
+    builder.putInt32(vec.x);
+    builder.putInt32(vec.y);
+    builder.putInt32(vec.z);
+}
+
+static glm::ivec3 read_ivec3(ByteReader& reader) {
+    int x = reader.getInt32();
+    int y = reader.getInt32();
+    int z = reader.getInt32();
+    return {x, y, z};
+}
+
+static void write_placements(
+    ByteBuilder& builder, const std::vector<Placement>& placements
+) {
+    builder.putInt32(placements.size());
+    for (const auto& placement : placements) {
+        builder.put(static_cast<ubyte>(placement.placement.index()));
+        builder.putInt32(placement.priority);
+        if (auto sp = std::get_if<StructurePlacement>(&placement.placement)) {
+            builder.putInt32(sp->structure);
+            write_ivec3(builder, sp->position);
+            builder.put(sp->rotation);
+        } else {
+            const auto& line = std::get<LinePlacement>(placement.placement);
+            builder.putInt16(line.block);
+            write_ivec3(builder, line.a);
+            write_ivec3(builder, line.b);
+            builder.putInt32(line.radius);
+        }
+    }
+}
+
+static std::vector<Placement> read_placements(ByteReader& reader) {
+    size_t count = static_cast<uint32_t>(reader.getInt32());
+    std::vector<Placement> placements;
+    placements.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        ubyte type = reader.get();
+        int priority = reader.getInt32();
+        if (type == 0) {
+            int structure = reader.getInt32();
+            auto position = read_ivec3(reader);
+            ubyte rotation = reader.get();
+            placements.emplace_back(
+                priority, StructurePlacement(structure, position, rotation)
+            );
+        } else if (type == 1) {
+            blockid_t block = reader.getInt16();
+            auto a = read_ivec3(reader);
+            auto b = read_ivec3(reader);
+            int radius = reader.getInt32();
+            placements.emplace_back(
+                priority, LinePlacement(block, a, b, radius)
+            );
+        } else {
+            throw std::runtime_error("invalid placement type");
+        }
+    }
+    return placements;
+}
+
+static void write_prototype(
+    ByteBuilder& builder, const CachedPrototype& prototype
+) {
+    ubyte flags = 0;
+    flags |= prototype.wideStructs ? FLAG_WIDE_STRUCTS : 0;
+    flags |= prototype.biomes.empty() ? 0 : FLAG_BIOMES;
+    flags |= prototype.heights.empty() ? 0 : FLAG_HEIGHTS;
+    flags |= prototype.structures ? FLAG_STRUCTURES : 0;
+    builder.put(flags);
+    if (prototype.wideStructs) {
+        write_placements(builder, *prototype.wideStructs);
+    }
+    if (!prototype.biomes.empty()) {
+        builder.putInt32(prototype.biomes.size());
+        for (uint16_t biome : prototype.biomes) {
+            builder.putInt16(biome);
+        }
+    }
+    if (!prototype.heights.empty()) {
+        builder.putInt32(prototype.heights.size());
+        for (float height : prototype.heights) {
+            builder.putFloat32(height);
+        }
+    }
+    if (prototype.structures) {
+        write_placements(builder, *prototype.structures);
+    }
+}
+
+static CachedPrototype read_prototype(ByteReader& reader) {
+    CachedPrototype prototype;
+    ubyte flags = reader.get();
+    if (flags & FLAG_WIDE_STRUCTS) {
+        prototype.wideStructs = read_placements(reader);
+    }
+    if (flags & FLAG_BIOMES) {
+        size_t count = static_cast<uint32_t>(reader.getInt32());
+        if (count * sizeof(uint16_t) > reader.remaining()) {
+            throw std::runtime_error("invalid biomes count");
+        }
+        prototype.biomes.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            prototype.biomes[i] = reader.getInt16();
+        }
+    }
+    if (flags & FLAG_HEIGHTS) {
+        size_t count = static_cast<uint32_t>(reader.getInt32());
+        if (count * sizeof(float) > reader.remaining()) {
+            throw std::runtime_error("invalid heights count");
+        }
+        prototype.heights.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            prototype.heights[i] = reader.getFloat32();
+        }
+    }
+    if (flags & FLAG_STRUCTURES) {
+        prototype.structures = read_placements(reader);
+    }
+    return prototype;
+}
+
+static constexpr size_t HEADER_SIZE = MAGIC_SIZE + 1 + 8 + 4;
+static constexpr size_t TABLE_ENTRY_SIZE = 2 + 4 + 4;
+
+/// @brief Read region file header and entries table.
+/// Missing, invalid or outdated file gives an empty table
+static PrototypesCache::RegionTable read_region_table(
+    const fs::path& file, uint64_t key
+) {
+    PrototypesCache::RegionTable table;
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream) {
+        return table;
+    }
+    try {
+        ubyte header[HEADER_SIZE];
+        if (!stream.read(reinterpret_cast<char*>(header), HEADER_SIZE)) {
+            throw std::runtime_error("unexpected end of file");
+        }
+        ByteReader reader(header, HEADER_SIZE);
+        reader.checkMagic(MAGIC, MAGIC_SIZE);
+        if (reader.get() != PrototypesCache::VERSION ||
+            static_cast<uint64_t>(reader.getInt64()) != key) {
+            return table;
+        }
+        size_t count = static_cast<uint32_t>(reader.getInt32());
+        constexpr int maxCount =
+            PrototypesCache::REGION_SIZE * PrototypesCache::REGION_SIZE;
+        if (count > maxCount) {
+            throw std::runtime_error("invalid entries count");
+        }
+        std::vector<ubyte> bytes(count * TABLE_ENTRY_SIZE);
+        if (!stream.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+            throw std::runtime_error("unexpected end of file");
+        }
+        ByteReader tableReader(bytes.data(), bytes.size());
+        for (size_t i = 0; i < count; i++) {
+            int localIndex = static_cast<uint16_t>(tableReader.getInt16());
+            uint32_t offset = tableReader.getInt32();
+            uint32_t size = tableReader.getInt32();
+            if (localIndex >= maxCount) {
+                throw std::runtime_error("invalid entry index");
+            }
+            table[localIndex] = {offset, size};
+        }
+    } catch (const std::runtime_error& err) {
+        logger.warning() << "invalid region file " << file.u8string() << ": "
+                         << err.what();
+        table.clear();
+    }
+    return table;
+}
+
+static std::vector<ubyte> read_region_entry(
+    const fs::path& file, const PrototypesCache::StoredEntry& entry
+) {
+    std::ifstream stream(file, std::ios::binary);
+    std::vector<ubyte> bytes(entry.size);
+    if (!stream.seekg(entry.offset) ||
+        !stream.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+        throw std::runtime_error("could not read entry");
+    }
+    return bytes;
+}
+
+/// @brief Write region file
+/// @param entries serialized entries mapped by local index
+/// @return written entries table
+static PrototypesCache::RegionTable write_region(
+    const fs::path& file,
+    uint64_t key,
+    const std::map<int, std::vector<ubyte>>& entries
+) {
+    PrototypesCache::RegionTable table;
+    ByteBuilder builder;
+    builder.put(reinterpret_cast<const ubyte*>(MAGIC), MAGIC_SIZE);
+    builder.put(PrototypesCache::VERSION);
+    builder.putInt64(key);
+    builder.putInt32(entries.size());
+    uint32_t offset = HEADER_SIZE + entries.size() * TABLE_ENTRY_SIZE;
+    for (const auto& [localIndex, bytes] : entries) {
+        builder.putInt16(localIndex);
+        builder.putInt32(offset);
+        builder.putInt32(bytes.size());
+        table[localIndex] = {offset, static_cast<uint32_t>(bytes.size())};
+        offset += bytes.size();
+    }
+    for (const auto& [localIndex, bytes] : entries) {
+        builder.put(bytes.data(), bytes.size());
+    }
+    fs::create_directories(file.parent_path());
+    auto tmpFile = file;
+    tmpFile += ".tmp";
+    if (!files::write_bytes(tmpFile, builder.data(), builder.size())) {
+        throw std::runtime_error("could not write " + tmpFile.u8string());
+    }
+    fs::rename(tmpFile, file);
+    return table;
+}
+
+static inline glm::ivec2 region_of(glm::ivec2 pos) {
+    return {
+        floordiv(pos.x, PrototypesCache::REGION_SIZE),
+        floordiv(pos.y, PrototypesCache::REGION_SIZE)};
+}
+
+static inline int local_index(glm::ivec2 pos, glm::ivec2 region) {
+    auto local = pos - region * PrototypesCache::REGION_SIZE;
+    return local.y * PrototypesCache::REGION_SIZE + local.x;
+}
+
+PrototypesCache::PrototypesCache(
+    size_t budget, uint64_t key, std::optional<fs::path> folder
+)
+    : budget(budget), key(key), folder(std::move(folder)) {
+}
+
+PrototypesCache::~PrototypesCache() {
+    flush();
+}
+
+PrototypesCache::Entry* PrototypesCache::find(int x, int z) {
+    const auto& found = index.find({x, z});
+    if (found == index.end()) {
+        return nullptr;
+    }
+    // move to front as the most recently used
+    entries.splice(entries.begin(), entries, found->second);
+    return &*found->second;
+}
+
+PrototypesCache::Entry& PrototypesCache::acquire(int x, int z) {
+    if (auto entry = find(x, z)) {
+        entry->modified = true;
+        return *entry;
+    }
+    entries.push_front(Entry {{x, z}, {}, 0, true});
+    index[{x, z}] = entries.begin();
+    auto& entry = entries.front();
+    updateUsage(entry);
+    return entry;
+}
+
+void PrototypesCache::updateUsage(Entry& entry) {
+    usage -= entry.usage;
+    entry.usage = entry.prototype.memoryUsage();
+    usage += entry.usage;
+}
+
+const CachedPrototype* PrototypesCache::get(int x, int z) {
+    if (auto entry = find(x, z)) {
+        return &entry->prototype;
+    }
+    if (!folder) {
+        return nullptr;
+    }
+    glm::ivec2 pos(x, z);
+    auto region = region_of(pos);
+    auto& table = getRegionTable(region);
+    const auto& found = table.find(local_index(pos, region));
+    if (found == table.end()) {
+        return nullptr;
+    }
+    auto file = getRegionFile(region);
+    CachedPrototype prototype;
+    try {
+        auto bytes = read_region_entry(file, found->second);
+        ByteReader reader(bytes.data(), bytes.size());
+        prototype = read_prototype(reader);
+    } catch (const std::runtime_error& err) {
+        logger.warning() << "invalid region file " << file.u8string() << ": "
+                         << err.what();
+        table.erase(found);
+        return nullptr;
+    }
+    entries.push_front(Entry {pos, std::move(prototype), 0, false});
+    index[pos] = entries.begin();
+    updateUsage(entries.front());
+    return &entries.front().prototype;
+}
+
+fs::path PrototypesCache::getRegionFile(glm::ivec2 region) const {
+    return *folder / fs::u8path(
+        std::to_string(region.x) + "_" + std::to_string(region.y) + ".bin"
+    );
+}
+
+PrototypesCache::RegionTable& PrototypesCache::getRegionTable(
+    glm::ivec2 region
+) {
+    const auto& found = regions.find(region);
+    if (found != regions.end()) {
+        return found->second;
+    }
+    return regions[region] = read_region_table(getRegionFile(region), key);
+}
+
+void PrototypesCache::spill(EntriesList& spilled) {
+    if (!folder || spilled.empty()) {
+        return;
+    }
+    std::unordered_map<glm::ivec2, std::vector<Entry*>> modified;
+    for (auto& entry : spilled) {
+        // entries loaded and not changed are already stored
+        if (entry.modified) {
+            modified[region_of(entry.pos)].push_back(&entry);
+        }
+    }
+    for (const auto& [region, regionEntries] : modified) {
+        auto file = getRegionFile(region);
+        auto& table = getRegionTable(region);
+        try {
+            std::map<int, std::vector<ubyte>> stored;
+            if (!table.empty()) {
+                auto bytes = files::read_bytes(file);
+                for (const auto& [localIndex, entry] : table) {
+                    if (entry.offset + entry.size > bytes.size()) {
+                        continue;
+                    }
+                    auto begin = bytes.begin() + entry.offset;
+                    stored[localIndex].assign(begin, begin + entry.size);
+                }
+            }
+            for (auto entry : regionEntries) {
+                ByteBuilder builder;
+                write_prototype(builder, entry->prototype);
+                stored[local_index(entry->pos, region)] = builder.build();
+            }
+            table = write_region(file, key, stored);
+        } catch (const std::runtime_error& err) {
+            logger.error() << "could not spill prototypes: " << err.what();
+        }
+    }
+}
+
+void PrototypesCache::setWideStructs(
+    int x, int z, std::vector<Placement> placements
+) {
+    auto& entry = acquire(x, z);
+    entry.prototype.wideStructs = std::move(placements);
+    updateUsage(entry);
+}
+
+void PrototypesCache::setBiomes(int x, int z, std::vector<uint16_t> biomes) {
+    auto& entry = acquire(x, z);
+    entry.prototype.biomes = std::move(biomes);
+    updateUsage(entry);
+}
+
+void PrototypesCache::setHeights(int x, int z, std::vector<float> heights) {
+    auto& entry = acquire(x, z);
+    entry.prototype.heights = std::move(heights);
+    updateUsage(entry);
+}
+
+void PrototypesCache::setStructures(
+    int x, int z, std::vector<Placement> placements
+) {
+    auto& entry = acquire(x, z);
+    entry.prototype.structures = std::move(placements);
+    updateUsage(entry);
+}
+
+void PrototypesCache::trim() {
+    if (usage <= budget) {
+        return;
+    }
+    // evict more than needed to not spill every frame
+    size_t target = budget / 4 * 3;
+    EntriesList spilled;
+    while (usage > target && !entries.empty()) {
+        auto last = std::prev(entries.end());
+        usage -= last->usage;
+        index.erase(last->pos);
+        spilled.splice(spilled.end(), entries, last);
+    }
+    spill(spilled);
+}
+
+void PrototypesCache::flush() {
+    if (!folder) {
+        return;
+    }
+    spill(entries);
+    entries.clear();
+    index.clear();
+    usage = 0;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <list>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <filesystem>
+#include <unordered_map>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+#include "typedefs.hpp"
+#include "StructurePlacement.hpp"
+
+namespace fs = std::filesystem;
+
+/// @brief Cached results of chunk prototype generation stages.
+/// Only values produced by the chunk itself are stored: placements are
+/// distributed to neighbour prototypes again on restore
+struct CachedPrototype {
+    /// @brief Wide structures placements made by the generator script
+    std::optional<std::vector<Placement>> wideStructs;
+    /// @brief Biome indices (CHUNK_W * CHUNK_D)
+    std::vector<uint16_t> biomes;
+    /// @brief Cropped heightmap values (CHUNK_W * CHUNK_D)
+    std::vector<float> heights;
+    /// @brief Structures placements made by the generator script
+    std::optional<std::vector<Placement>> structures;
+
+    /// @brief Approximate number of bytes used by the entry
+    size_t memoryUsage() const;
+};
+
+/// @brief Chunk prototypes cache with LRU memory budget.
+///
+/// When a folder is specified, entries exceeding the budget (and all entries
+/// on flush) are spilled to region files of REGION_SIZE x REGION_SIZE chunks.
+/// Region file starts with an entries table, so a single entry is read
+/// back on demand. Files written with another key are ignored.
+class PrototypesCache {
+public:
+    /// @brief Location of an entry in the region file
+    struct StoredEntry {
+        uint32_t offset;
+        uint32_t size;
+    };
+    /// @brief Region file entries mapped by local index
+    using RegionTable = std::unordered_map<int, StoredEntry>;
+private:
+    struct Entry {
+        glm::ivec2 pos;
+        CachedPrototype prototype;
+        size_t usage = 0;
+        /// @brief Entry is not stored or changed since read
+        bool modified = true;
+    };
+    using EntriesList = std::list<Entry>;
+
+    size_t budget;
+    uint64_t key;
+    std::optional<fs::path> folder;
+
+    /// @brief Most recently used entries first
+    EntriesList entries;
+    std::unordered_map<glm::ivec2, EntriesList::iterator> index;
+    /// @brief Entries tables of region files read or written
+    std::unordered_map<glm::ivec2, RegionTable> regions;
+    size_t usage = 0;
+
+    Entry* find(int x, int z);
+    Entry& acquire(int x, int z);
+    void updateUsage(Entry& entry);
+
+    fs::path getRegionFile(glm::ivec2 region) const;
+    /// @brief Get region entries table. Read from file on first access
+    RegionTable& getRegionTable(glm::ivec2 region);
+    /// @brief Write modified entries to their regions files, merging with
+    /// the stored ones. Each region file is written once
+    void spill(EntriesList& spilled);
+public:
+    static constexpr int VERSION = 2;
+    static constexpr int REGION_SIZE = 16;
+
+    /// @param budget max memory used by in-memory entries
+    /// @param key generation parameters hash (generator, seed, content)
+    /// @param folder spill folder or std::nullopt to keep memory only
+    PrototypesCache(
+        size_t budget, uint64_t key, std::optional<fs::path> folder
+    );
+    ~PrototypesCache();
+
+    /// @return nullptr if chunk stages are not cached
+    const CachedPrototype* get(int x, int z);
+
+    void setWideStructs(int x, int z, std::vector<Placement> placements);
+    void setBiomes(int x, int z, std::vector<uint16_t> biomes);
+    void setHeights(int x, int z, std::vector<float> heights);
+    void setStructures(int x, int z, std::vector<Placement> placements);
+
+    /// @brief Evict least recently used entries if the memory budget is
+    /// exceeded. Usage is reduced to 3/4 of the budget to spill in batches
+    void trim();
+
+    /// @brief Spill all entries to files (does nothing if no folder)
+    void flush();
+
+    /// @brief Get approximate memory used by in-memory entries
+    size_t getMemoryUsage() const {
+        return usage;
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+};
@@ -8,12 +8,15 @@
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
 #include "GeneratorDef.hpp"
+#include "PrototypesCache.hpp"
 #include "VoxelFragment.hpp"
 #include "util/timeutil.hpp"
 #include "util/listutil.hpp"
+#include "util/hash.hpp"
 #include "maths/voxmaths.hpp"
 #include "maths/util.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 
 static debug::Logger logger("world-generator");
 
@@ -24,7 +27,11 @@ static inline constexpr uint MAX_PARAMETERS = 4;
 static inline constexpr uint BASIC_PROTOTYPE_LAYERS = 5;
 
 WorldGenerator::WorldGenerator(
-    const GeneratorDef& def, const Content* content, uint64_t seed
+    const GeneratorDef& def,
+    const Content* content,
+    uint64_t seed,
+    size_t cacheBudget,
+    std::optional<std::filesystem::path> cacheFolder
 )
     : def(def), 
       content(content), 
@@ -72,10 +79,49 @@ WorldGenerator::WorldGenerator(
                 def.structures[i]->fragments[j-1]->rotated(*content);
         }
     }
+    if (cacheBudget) {
+        cache = std::make_unique<PrototypesCache>(
+            cacheBudget, calculateCacheKey(), std::move(cacheFolder)
+        );
+    }
 }
 
 WorldGenerator::~WorldGenerator() {}
 
+uint64_t WorldGenerator::calculateCacheKey() const {
+    util::Hasher64 hasher;
+    hasher.update(def.name);
+    hasher.update(def.scriptHash);
+    hasher.update(seed);
+    hasher.update(static_cast<uint64_t>(CHUNK_W));
+    hasher.update(static_cast<uint64_t>(CHUNK_D));
+    hasher.update(static_cast<uint64_t>(CHUNK_H));
+    hasher.update(static_cast<uint64_t>(def.biomeParameters));
+    hasher.update(static_cast<uint64_t>(def.biomesBPD));
+    hasher.update(static_cast<uint64_t>(def.heightsBPD));
+    hasher.update(static_cast<uint64_t>(def.biomesInterpolation));
+    hasher.update(static_cast<uint64_t>(def.heightsInterpolation));
+    hasher.update(static_cast<uint64_t>(def.wideStructsChunksRadius));
+    for (uint8_t input : def.heightmapInputs) {
+        hasher.update(static_cast<uint64_t>(input));
+    }
+    for (const auto& biome : def.biomes) {
+        hasher.update(biome.name);
+        for (const auto& parameter : biome.parameters) {
+            hasher.update(&parameter.value, sizeof(parameter.value));
+            hasher.update(&parameter.weight, sizeof(parameter.weight));
+        }
+    }
+    for (const auto& structure : def.structures) {
+        hasher.update(structure->meta.name);
+    }
+    // line placements store runtime block ids
+    for (const auto& block : content->getIndices()->blocks.getIterable()) {
+        hasher.update(block->name);
+    }
+    return hasher.value();
+}
+
 ChunkPrototype& WorldGenerator::requirePrototype(int x, int z) {
     const auto& found = prototypes.find({x, z});
     if (found == prototypes.end()) {
@@ -229,9 +275,19 @@ void WorldGenerator::generateStructuresWide(
     if (prototype.level >= ChunkPrototypeLevel::WIDE_STRUCTS) {
         return;
     }
-    auto placements = def.script->placeStructuresWide(
-        {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D}, CHUNK_H
-    );
+    PROFILE_SCOPE("generator.structures_wide");
+    auto cached = cache ? cache->get(chunkX, chunkZ) : nullptr;
+    std::vector<Placement> placements;
+    if (cached && cached->wideStructs) {
+        placements = *cached->wideStructs;
+    } else {
+        placements = def.script->placeStructuresWide(
+            {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D}, CHUNK_H
+        );
+        if (cache) {
+            cache->setWideStructs(chunkX, chunkZ, placements);
+        }
+    }
     placeStructures(placements, prototype, chunkX, chunkZ);
 
     prototype.level = ChunkPrototypeLevel::WIDE_STRUCTS;
@@ -243,13 +299,23 @@ void WorldGenerator::generateStructures(
     if (prototype.level >= ChunkPrototypeLevel::STRUCTURES) {
         return;
     }
+    PROFILE_SCOPE("generator.structures");
     const auto& biomes = prototype.biomes;
     const auto& heightmap = prototype.heightmap;
 
-    auto placements = def.script->placeStructures(
-        {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D},
-        heightmap, CHUNK_H
-    );
+    auto cached = cache ? cache->get(chunkX, chunkZ) : nullptr;
+    std::vector<Placement> placements;
+    if (cached && cached->structures) {
+        placements = *cached->structures;
+    } else {
+        placements = def.script->placeStructures(
+            {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D},
+            heightmap, CHUNK_H
+        );
+        if (cache) {
+            cache->setStructures(chunkX, chunkZ, placements);
+        }
+    }
     placeStructures(placements, prototype, chunkX, chunkZ);
 
     util::PseudoRandom structsRand;
@@ -296,6 +362,10 @@ void WorldGenerator::generateBiomes(
     if (prototype.level >= ChunkPrototypeLevel::BIOMES) {
         return;
     }
+    PROFILE_SCOPE("generator.biomes");
+    if (restoreBiomes(prototype, chunkX, chunkZ)) {
+        return;
+    }
     uint bpd = def.biomesBPD;
     auto biomeParams = def.script->generateParameterMaps(
         {floordiv(chunkX * CHUNK_W, bpd), floordiv(chunkZ * CHUNK_D, bpd)},
@@ -313,10 +383,10 @@ void WorldGenerator::generateBiomes(
         prototype.heightmapInputs.push_back(std::move(copy));
     }
     for (const auto& map : biomeParams) {
-        map->resize(
-            CHUNK_W + bpd, CHUNK_D + bpd, def.biomesInterpolation
+        map->resizeAndCrop(
+            CHUNK_W + bpd, CHUNK_D + bpd, 0, 0, CHUNK_W, CHUNK_D,
+            def.biomesInterpolation
         );
-        map->crop(0, 0, CHUNK_W, CHUNK_D);
     }
     const auto& biomes = def.biomes;
 
@@ -327,8 +397,40 @@ void WorldGenerator::generateBiomes(
                 choose_biome(biomes, biomeParams, x, z);
         }
     }
+    if (cache) {
+        std::vector<uint16_t> indices(CHUNK_W * CHUNK_D);
+        for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+            indices[i] = chunkBiomes[i] - biomes.data();
+        }
+        cache->setBiomes(chunkX, chunkZ, std::move(indices));
+    }
+    prototype.biomes = std::move(chunkBiomes);
+    prototype.level = ChunkPrototypeLevel::BIOMES;
+}
+
+bool WorldGenerator::restoreBiomes(
+    ChunkPrototype& prototype, int chunkX, int chunkZ
+) {
+    auto cached = cache ? cache->get(chunkX, chunkZ) : nullptr;
+    if (cached == nullptr || cached->biomes.size() != CHUNK_W * CHUNK_D) {
+        return false;
+    }
+    // heightmap inputs are not cached, so heights are required too
+    if (!def.heightmapInputs.empty() &&
+        cached->heights.size() != CHUNK_W * CHUNK_D) {
+        return false;
+    }
+    auto chunkBiomes = std::make_unique<const Biome*[]>(CHUNK_W*CHUNK_D);
+    for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+        uint16_t index = cached->biomes[i];
+        if (index >= def.biomes.size()) {
+            return false;
+        }
+        chunkBiomes[i] = &def.biomes[index];
+    }
     prototype.biomes = std::move(chunkBiomes);
     prototype.level = ChunkPrototypeLevel::BIOMES;
+    return true;
 }
 
 void WorldGenerator::generateHeightmap(
@@ -337,6 +439,14 @@ void WorldGenerator::generateHeightmap(
     if (prototype.level >= ChunkPrototypeLevel::HEIGHTMAP) {
         return;
     }
+    PROFILE_SCOPE("generator.heightmap");
+    auto cached = cache ? cache->get(chunkX, chunkZ) : nullptr;
+    if (cached && cached->heights.size() == CHUNK_W * CHUNK_D) {
+        prototype.heightmap =
+            std::make_shared<Heightmap>(CHUNK_W, CHUNK_D, cached->heights);
+        prototype.level = ChunkPrototypeLevel::HEIGHTMAP;
+        return;
+    }
     uint bpd = def.heightsBPD;
     prototype.heightmap = def.script->generateHeightmap(
         {floordiv(chunkX * CHUNK_W, bpd), floordiv(chunkZ * CHUNK_D, bpd)},
@@ -345,10 +455,16 @@ void WorldGenerator::generateHeightmap(
         prototype.heightmapInputs
     );
     prototype.heightmap->clamp();
-    prototype.heightmap->resize(
-        CHUNK_W + bpd, CHUNK_D + bpd, def.heightsInterpolation
+    prototype.heightmap->resizeAndCrop(
+        CHUNK_W + bpd, CHUNK_D + bpd, 0, 0, CHUNK_W, CHUNK_D,
+        def.heightsInterpolation
     );
-    prototype.heightmap->crop(0, 0, CHUNK_W, CHUNK_D);
+    if (cache) {
+        const float* values = prototype.heightmap->getValues();
+        cache->setHeights(
+            chunkX, chunkZ, std::vector<float>(values, values + CHUNK_W*CHUNK_D)
+        );
+    }
     prototype.level = ChunkPrototypeLevel::HEIGHTMAP;
 }
 
@@ -357,6 +473,9 @@ void WorldGenerator::update(int centerX, int centerY, int loadDistance) {
     // 1 is safety padding preventing ChunksController rounding problem
     surroundMap.resize(loadDistance + 1);
     surroundMap.setCenter(centerX, centerY);
+    if (cache) {
+        cache->trim();
+    }
 }
 
 void WorldGenerator::generatePlants(
@@ -422,6 +541,7 @@ void WorldGenerator::generateLand(
 }
 
 void WorldGenerator::generate(voxel* voxels, int chunkX, int chunkZ) {
+    PROFILE_SCOPE("generator.generate");
     surroundMap.completeAt(chunkX, chunkZ);
 
     const auto& prototype = requirePrototype(chunkX, chunkZ);
@@ -588,11 +708,10 @@ void WorldGenerator::generateLine(
 
 WorldGenDebugInfo WorldGenerator::createDebugInfo() const {
     const auto& area = surroundMap.getArea();
-    const auto& levels = area.getBuffer();
-    auto values = std::make_unique<ubyte[]>(area.getWidth()*area.getHeight());
+    auto values = std::make_unique<ubyte[]>(area.area());
 
-    for (uint i = 0; i < levels.size(); i++) {
-        values[i] = levels[i];
+    for (uint i = 0; i < area.area(); i++) {
+        values[i] = area[i];
     }
 
     return WorldGenDebugInfo {
@@ -4,6 +4,8 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <optional>
+#include <filesystem>
 #include <unordered_map>
 
 #include "constants.hpp"
@@ -17,6 +19,7 @@ struct GeneratorDef;
 class Heightmap;
 struct Biome;
 class VoxelFragment;
+class PrototypesCache;
 
 enum class ChunkPrototypeLevel {
     VOID=0, WIDE_STRUCTS, BIOMES, HEIGHTMAP, STRUCTURES
@@ -57,6 +60,11 @@ class WorldGenerator {
     std::unordered_map<glm::ivec2, std::unique_ptr<ChunkPrototype>> prototypes;
     /// @brief Chunk prototypes loading surround map
     SurroundMap surroundMap;
+    /// @brief Generation stages results cache (nullptr if disabled)
+    std::unique_ptr<PrototypesCache> cache;
+
+    /// @brief Hash of parameters the generation stages results depend on
+    uint64_t calculateCacheKey() const;
 
     /// @brief Generate chunk prototype (see ChunkPrototype)
     /// @param x chunk position X divided by CHUNK_W
@@ -71,6 +79,10 @@ class WorldGenerator {
 
     void generateBiomes(ChunkPrototype& prototype, int x, int z);
 
+    /// @brief Restore prototype biomes from the cache
+    /// @return false if biomes are not cached
+    bool restoreBiomes(ChunkPrototype& prototype, int x, int z);
+
     void generateHeightmap(ChunkPrototype& prototype, int x, int z);
 
     void placeStructure(
@@ -118,10 +130,15 @@ class WorldGenerator {
         int x, int z
     );
 public:
+    /// @param cacheBudget prototypes cache memory budget (0 - disabled)
+    /// @param cacheFolder prototypes cache spill folder (std::nullopt -
+    /// evicted entries are dropped)
     WorldGenerator(
         const GeneratorDef& def,
         const Content* content,
-        uint64_t seed
+        uint64_t seed,
+        size_t cacheBudget = 0,
+        std::optional<std::filesystem::path> cacheFolder = std::nullopt
     );
     ~WorldGenerator();
 
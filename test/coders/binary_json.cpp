@@ -2,6 +2,8 @@
 
 #include "util/Buffer.hpp"
 #include "coders/binary_json.hpp"
+#include "coders/byte_utils.hpp"
+#include "coders/gzip.hpp"
 
 TEST(BJSON, EncodeDecode) {
     const std::string name = "JSON-encoder";
@@ -36,3 +38,50 @@ TEST(BJSON, EncodeDecode) {
         }
     }
 }
+
+TEST(BJSON, NestedWriteToBuilder) {
+    auto object = dv::object();
+    auto* current = &object;
+    for (int i = 0; i < 64; i++) {
+        (*current)["depth"] = i;
+        current = &current->object("child");
+    }
+    for (bool compress : {false, true}) {
+        ByteBuilder builder;
+        builder.putInt32(42);
+        json::to_binary(builder, object, compress);
+
+        auto bytes = builder.build();
+        EXPECT_TRUE(builder.size() == 0);
+        ByteReader reader(bytes.data(), bytes.size());
+        EXPECT_EQ(reader.getInt32(), 42);
+        auto decoded = json::from_binary(reader.pointer(), reader.remaining());
+
+        const auto* node = &decoded;
+        for (int i = 0; i < 64; i++) {
+            EXPECT_EQ((*node)["depth"].asInteger(), i);
+            node = &(*node)["child"];
+        }
+        EXPECT_TRUE(node->empty());
+    }
+}
+
+TEST(BJSON, GzipCompressor) {
+    std::vector<ubyte> src(100000);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = i % 7 == 0 ? rand() : i / 100;
+    }
+    ByteBuilder builder;
+    {
+        gzip::Compressor compressor(builder);
+        for (size_t i = 0; i < src.size(); i += 4096) {
+            compressor.write(
+                src.data() + i, std::min<size_t>(4096, src.size() - i)
+            );
+        }
+        compressor.finish();
+    }
+    auto compressed = builder.build();
+    EXPECT_EQ(compressed, gzip::compress(src.data(), src.size()));
+    EXPECT_EQ(gzip::decompress(compressed.data(), compressed.size()), src);
+}
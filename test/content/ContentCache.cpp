@@ -0,0 +1,40 @@
+#include "content/ContentCache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "files/files.hpp"
+
+TEST(ContentCache, ReadAndReload) {
+    auto folder = fs::temp_directory_path() / fs::u8path("vecontentcache");
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    auto defFile = folder / fs::u8path("block.json");
+    auto cacheFile = folder / fs::u8path("cache/defs.bin");
+    files::write_string(defFile, R"({"material": "base:stone", "hidden": true})");
+
+    {
+        ContentCache cache(cacheFile);
+        auto root = cache.read(defFile);
+        EXPECT_EQ(root["material"].asString(), "base:stone");
+        EXPECT_EQ(cache.getMisses(), 1);
+        cache.read(defFile);
+        EXPECT_EQ(cache.getHits(), 1);
+        cache.save();
+    }
+    {
+        ContentCache cache(cacheFile);
+        auto root = cache.read(defFile);
+        EXPECT_EQ(cache.getHits(), 1);
+        EXPECT_EQ(cache.getMisses(), 0);
+        EXPECT_TRUE(root["hidden"].asBoolean());
+        EXPECT_EQ(root["material"].asString(), "base:stone");
+    }
+    files::write_string(defFile, R"({"material": "base:grass"})");
+    {
+        ContentCache cache(cacheFile);
+        auto root = cache.read(defFile);
+        EXPECT_EQ(cache.getMisses(), 1);
+        EXPECT_EQ(root["material"].asString(), "base:grass");
+    }
+    fs::remove_all(folder);
+}
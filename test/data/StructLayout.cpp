@@ -131,3 +131,20 @@ TEST(StructLayout, Serialization) {
 
     EXPECT_EQ(layout1, layout2);
 }
+
+TEST(StructLayout, FieldIndex) {
+    std::vector<Field> fields {
+        Field {FieldType::I8, "a", 1},
+        Field {FieldType::F64, "b", 2},
+    };
+    auto layout = StructLayout::create(fields);
+    EXPECT_EQ(layout.countFields(), 2);
+    EXPECT_EQ(layout.getFieldIndex("c"), -1);
+    EXPECT_EQ(layout.getFieldAt(2), nullptr);
+
+    for (const auto& field : layout) {
+        int index = layout.getFieldIndex(field.name);
+        ASSERT_NE(index, -1);
+        EXPECT_EQ(layout.getFieldAt(index), layout.getField(field.name));
+    }
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <thread>
 
 #include "data/dv.hpp"
 
@@ -27,3 +28,33 @@ TEST(dv, dv) {
         }
     }
 }
+
+TEST(dv, Arena) {
+    dv::value value;
+    {
+        dv::ArenaScope arena(1024);
+        value = dv::object();
+        auto& list = value.list("elements");
+        for (int i = 0; i < 100; i++) {
+            auto& obj = list.object();
+            obj["index"] = i;
+            obj["position"] = dv::list({i, -i, 2 * i});
+        }
+    }
+    // values outlive the scope and may be modified without it
+    value["elements"][10]["tag"] = dv::list({1, 2, 3});
+    value.erase("missing");
+
+    // and freed by another thread
+    std::thread thread([value = std::move(value)]() mutable {
+        const auto& list = value["elements"];
+        EXPECT_EQ(list.size(), 100);
+        for (size_t i = 0; i < list.size(); i++) {
+            EXPECT_EQ(list[i]["index"].asInteger(), i);
+            EXPECT_EQ(list[i]["position"][2].asInteger(), 2 * i);
+        }
+        EXPECT_EQ(list[10]["tag"][2].asInteger(), 3);
+        value = nullptr;
+    });
+    thread.join();
+}
@@ -0,0 +1,52 @@
+#include "debug/Profiler.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+using namespace debug;
+
+TEST(Profiler, FrameStats) {
+    static profiler::Site site("test.frame-stats");
+    profiler::reset();
+    for (int i = 0; i < 3; i++) {
+        profiler::Scope scope(site);
+    }
+    std::thread([]() {
+        profiler::Scope scope(site);
+    }).join();
+    profiler::end_frame();
+
+    bool found = false;
+    for (const auto& stats : profiler::get_stats()) {
+        if (stats.name == site.getName()) {
+            EXPECT_EQ(stats.lastCalls, 4u);
+            EXPECT_EQ(stats.frames, 1u);
+            int total = 0;
+            for (auto count : stats.histogram) {
+                total += count;
+            }
+            EXPECT_EQ(total, 1);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(Profiler, Trace) {
+    static profiler::Site site("test.trace");
+    profiler::set_tracing(true);
+    {
+        profiler::Scope scope(site);
+    }
+    profiler::set_tracing(false);
+    {
+        profiler::Scope scope(site);
+    }
+    std::stringstream ss;
+    profiler::write_trace(ss);
+    std::string trace = ss.str();
+    size_t pos = trace.find("\"test.trace\"");
+    EXPECT_NE(pos, std::string::npos);
+    EXPECT_EQ(trace.find("\"test.trace\"", pos + 1), std::string::npos);
+}
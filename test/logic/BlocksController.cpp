@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "../test_utils.hpp"
+#include "content/Content.hpp"
+#include "logic/BlocksController.hpp"
+#include "settings.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "world/Level.hpp"
+
+TEST(BlocksController, FilterRandomUpdates) {
+    test::TempDirectory directory("random-updates");
+    auto content = test::create_content();
+    EngineSettings settings;
+    auto level = test::create_level(*content, settings, directory.get());
+    test::fill_level(*level, 1);
+    BlocksController controller(level.get(), 0);
+
+    auto stone = content->blocks.require(test::STONE).rt.id;
+    auto glass = content->blocks.require(test::GLASS).rt.id;
+    int y = test::GROUND_HEIGHT - 1;
+    std::vector<int32_t> coords {0, y, 0, 1, y, 0, 2, y, 0};
+    // an earlier handler replaces the second hit block
+    level->chunks->set(1, y, 0, glass, {});
+
+    controller.filterRandomUpdates(stone, coords);
+    EXPECT_EQ(coords, std::vector<int32_t>({0, y, 0, 2, y, 0}));
+    for (size_t i = 0; i < coords.size(); i += 3) {
+        EXPECT_EQ(
+            level->chunks->require(coords[i], coords[i + 1], coords[i + 2]).id,
+            stone
+        );
+    }
+}
+
+namespace {
+    struct TestWorld {
+        test::TempDirectory directory;
+        EngineSettings settings;
+        std::unique_ptr<Level> level;
+        std::unique_ptr<BlocksController> controller;
+
+        TestWorld(const Content& content, const std::string& name)
+            : directory(name) {
+            level = test::create_level(content, settings, directory.get());
+            test::fill_level(*level, 2);
+            controller = std::make_unique<BlocksController>(level.get(), 0);
+        }
+    };
+}
+
+/// @brief Place a lamp, dig under a flower (broken by neighbour update)
+/// and cover the lamp with glass
+static void edit(TestWorld& world, const Content& content) {
+    const auto& stone = content.blocks.require(test::STONE);
+    const auto& glass = content.blocks.require(test::GLASS);
+    const auto& lamp = content.blocks.require(test::LAMP);
+    auto& blocks = *world.controller;
+    int y = test::GROUND_HEIGHT;
+
+    blocks.placeBlock(nullptr, lamp, {}, 2, y, 2);
+    blocks.breakBlock(nullptr, stone, 5, y - 1, 5);
+    blocks.breakBlock(nullptr, stone, 5, y - 2, 5);
+    blocks.placeBlock(nullptr, glass, {}, 2, y + 1, 2);
+    blocks.breakBlock(nullptr, stone, 2, y - 1, 2);
+}
+
+static void expect_equal_chunks(const Level& a, const Level& b) {
+    for (int cz = -1; cz <= 1; cz++) {
+        for (int cx = -1; cx <= 1; cx++) {
+            const auto& chunkA = *a.chunks->getChunk(cx, cz);
+            const auto& chunkB = *b.chunks->getChunk(cx, cz);
+            for (int i = 0; i < CHUNK_VOL; i++) {
+                ASSERT_EQ(chunkA.voxels[i].id, chunkB.voxels[i].id);
+                ASSERT_EQ(
+                    chunkA.lightmap.getLights()[i],
+                    chunkB.lightmap.getLights()[i]
+                );
+            }
+        }
+    }
+}
+
+TEST(BlocksController, BatchMatchesImmediate) {
+    auto content = test::create_content();
+    const auto& flower = content->blocks.require(test::FLOWER);
+    int y = test::GROUND_HEIGHT;
+
+    TestWorld immediate(*content, "blocks-immediate");
+    TestWorld batched(*content, "blocks-batched");
+    for (auto world : {&immediate, &batched}) {
+        world->controller->placeBlock(nullptr, flower, {}, 5, y, 5);
+    }
+
+    edit(immediate, *content);
+    EXPECT_EQ(immediate.level->chunks->require(5, y, 5).id, BLOCK_AIR);
+
+    auto& blocks = *batched.controller;
+    blocks.beginBatch();
+    blocks.beginBatch();
+    edit(batched, *content);
+    blocks.endBatch();
+    // nested batch end defers updates to the outermost one
+    EXPECT_TRUE(blocks.isBatchActive());
+    EXPECT_EQ(batched.level->chunks->require(5, y, 5).id, flower.rt.id);
+    EXPECT_EQ(batched.level->chunks->getChunk(0, 0)->lightmap.getR(3, y, 2), 0);
+    blocks.endBatch();
+    EXPECT_FALSE(blocks.isBatchActive());
+
+    expect_equal_chunks(*immediate.level, *batched.level);
+}
+
+TEST(BlocksController, UnclosedBatchFlushedByUpdate) {
+    auto content = test::create_content();
+    const auto& lamp = content->blocks.require(test::LAMP);
+    int y = test::GROUND_HEIGHT;
+
+    TestWorld world(*content, "blocks-unclosed");
+    auto& blocks = *world.controller;
+    const auto& lightmap = world.level->chunks->getChunk(0, 0)->lightmap;
+
+    blocks.beginBatch();
+    blocks.placeBlock(nullptr, lamp, {}, 2, y, 2);
+    EXPECT_EQ(lightmap.getR(3, y, 2), 0);
+
+    blocks.update(0.0f);
+    EXPECT_FALSE(blocks.isBatchActive());
+    EXPECT_GT(lightmap.getR(3, y, 2), 0);
+}
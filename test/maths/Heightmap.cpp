@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "maths/Heightmap.hpp"
+
+/// @brief Reference per-pixel sampling
+static float sample_reference(
+    const Heightmap& map, float x, float y, InterpolationType interp
+) {
+    const float* buffer = map.getValues();
+    uint width = map.getWidth();
+    uint height = map.getHeight();
+    auto at = [=](uint x, uint y) {
+        return buffer[(y >= height ? height - 1 : y) * width +
+                      (x >= width ? width - 1 : x)];
+    };
+    auto cubic = [](float p[4], float x) -> float {
+        return p[1] + 0.5 * x*(p[2] - p[0] + x*(2.0*p[0] - 5.0*p[1] + 
+               4.0*p[2] - p[3] + x*(3.0*(p[1] - p[2]) + p[3] - p[0])));
+    };
+    uint ix = static_cast<uint>(x);
+    uint iy = static_cast<uint>(y);
+    float tx = x - ix;
+    float ty = y - iy;
+    switch (interp) {
+        case InterpolationType::NEAREST:
+            return at(ix, iy);
+        case InterpolationType::LINEAR: {
+            float s00 = at(ix, iy);
+            float s10 = at(ix + 1, iy);
+            float s01 = at(ix, iy + 1);
+            float s11 = at(ix + 1, iy + 1);
+            return s00 + (s10 - s00) * tx + (s01 - s00) * ty +
+                   (s11 - s10 - s01 + s00) * tx * ty;
+        }
+        case InterpolationType::CUBIC: {
+            float q[4];
+            for (int i = 0; i < 4; i++) {
+                float p[4];
+                for (int j = 0; j < 4; j++) {
+                    p[j] = at(ix + j - 1, iy + i - 1);
+                }
+                q[i] = cubic(p, tx);
+            }
+            return cubic(q, ty);
+        }
+    }
+    return 0.0f;
+}
+
+static Heightmap random_map(uint width, uint height) {
+    std::mt19937 random(width * 31 + height);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<float> values(width * height);
+    for (auto& value : values) {
+        value = distribution(random);
+    }
+    return Heightmap(width, height, std::move(values));
+}
+
+static const InterpolationType INTERPOLATIONS[] {
+    InterpolationType::NEAREST,
+    InterpolationType::LINEAR,
+    InterpolationType::CUBIC,
+};
+
+TEST(Heightmap, Resize) {
+    for (auto interp : INTERPOLATIONS) {
+        auto source = random_map(5, 7);
+        for (auto [width, height] : {std::pair(20, 28), std::pair(3, 9)}) {
+            Heightmap map = source;
+            map.resize(width, height, interp);
+            ASSERT_EQ(map.getWidth(), width);
+            ASSERT_EQ(map.getHeight(), height);
+            for (uint y = 0; y < height; y++) {
+                for (uint x = 0; x < width; x++) {
+                    float sx = static_cast<float>(x) / width * 5;
+                    float sy = static_cast<float>(y) / height * 7;
+                    EXPECT_NEAR(
+                        map.get(x, y),
+                        sample_reference(source, sx, sy, interp),
+                        1e-5f
+                    );
+                }
+            }
+        }
+    }
+}
+
+TEST(Heightmap, Crop) {
+    auto source = random_map(9, 6);
+    Heightmap map = source;
+    map.crop(2, 1, 5, 4);
+    ASSERT_EQ(map.getWidth(), 5);
+    ASSERT_EQ(map.getHeight(), 4);
+    for (uint y = 0; y < 4; y++) {
+        for (uint x = 0; x < 5; x++) {
+            EXPECT_EQ(map.get(x, y), source.get(x + 2, y + 1));
+        }
+    }
+    EXPECT_THROW(map.crop(1, 0, 5, 4), std::runtime_error);
+}
+
+TEST(Heightmap, ResizeAndCrop) {
+    for (auto interp : INTERPOLATIONS) {
+        auto source = random_map(5, 5);
+        Heightmap expected = source;
+        expected.resize(20, 20, interp);
+        expected.crop(3, 2, 16, 16);
+
+        Heightmap map = source;
+        map.resizeAndCrop(20, 20, 3, 2, 16, 16, interp);
+        ASSERT_EQ(map.getWidth(), 16);
+        ASSERT_EQ(map.getHeight(), 16);
+        for (uint y = 0; y < 16; y++) {
+            for (uint x = 0; x < 16; x++) {
+                EXPECT_EQ(map.get(x, y), expected.get(x, y));
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include "objects/entities_io.hpp"
+
+#include <gtest/gtest.h>
+
+#include "coders/binary_json.hpp"
+
+static std::vector<SavedEntity> create_entities() {
+    std::vector<SavedEntity> entities;
+    for (int i = 0; i < 10; i++) {
+        SavedEntity entity;
+        entity.def = i % 3 ? "base:drop" : "base:player";
+        entity.uid = 1000 + i;
+        entity.pos = glm::vec3(i * 0.5f, 64.0f, -i * 0.25f);
+        if (i % 2) {
+            entity.size = glm::vec3(0.25f);
+            entity.velocity = glm::vec3(0.0f, -9.8f, i);
+            entity.damping = 1.5f;
+            entity.crouching = true;
+        }
+        if (i % 4 == 0) {
+            entity.rot = glm::mat3(0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0, 0, 1);
+            entity.bodyType = BodyType::KINEMATIC;
+            entity.bodyEnabled = false;
+            entity.skeleton = "base:item";
+            entity.textures["$0"] = "blocks:stone";
+            entity.pose.resize(3, glm::mat4(i));
+        }
+        if (i % 3) {
+            entity.components = dv::object();
+            auto& drop = entity.components.object("base:drop");
+            drop["count"] = i;
+            drop["item"] = "base:stone.item";
+        }
+        entities.push_back(std::move(entity));
+    }
+    return entities;
+}
+
+static void expect_equal(const SavedEntity& a, const SavedEntity& b) {
+    EXPECT_EQ(a.def, b.def);
+    EXPECT_EQ(a.uid, b.uid);
+    EXPECT_EQ(a.pos, b.pos);
+    EXPECT_EQ(a.size, b.size);
+    EXPECT_EQ(a.rot, b.rot);
+    EXPECT_EQ(a.bodyEnabled, b.bodyEnabled);
+    EXPECT_EQ(a.velocity, b.velocity);
+    EXPECT_EQ(a.damping, b.damping);
+    EXPECT_EQ(a.bodyType, b.bodyType);
+    EXPECT_EQ(a.crouching, b.crouching);
+    EXPECT_EQ(a.skeleton, b.skeleton);
+    EXPECT_EQ(a.textures, b.textures);
+    EXPECT_EQ(a.pose, b.pose);
+    if (a.components.isObject()) {
+        EXPECT_EQ(
+            a.components["base:drop"]["count"].asInteger(),
+            b.components["base:drop"]["count"].asInteger()
+        );
+    } else {
+        EXPECT_TRUE(b.components.empty());
+    }
+}
+
+TEST(entities_io, EncodeDecode) {
+    auto entities = create_entities();
+    auto bytes = entities_io::encode(entities);
+    EXPECT_EQ(bytes[0], entities_io::MAGIC);
+
+    auto decoded = entities_io::decode(bytes.data(), bytes.size());
+    ASSERT_EQ(decoded.size(), entities.size());
+    for (size_t i = 0; i < entities.size(); i++) {
+        expect_equal(entities[i], decoded[i]);
+    }
+
+    auto empty = entities_io::encode({});
+    EXPECT_TRUE(entities_io::decode(empty.data(), empty.size()).empty());
+}
+
+TEST(entities_io, DecodeLegacy) {
+    auto root = dv::object();
+    auto& list = root.list("data");
+    auto& entity = list.object();
+    entity["def"] = "base:drop";
+    entity["uid"] = 42;
+    auto& transform = entity.object(entities_io::COMP_TRANSFORM);
+    transform["pos"] = dv::list({1.0, 2.0, 3.0});
+    transform["size"] = dv::list({0.5, 0.5, 0.5});
+    auto& body = entity.object(entities_io::COMP_RIGIDBODY);
+    body["vel"] = dv::list({0.0, -1.0, 0.0});
+    body["damping"] = 2.5;
+    body["type"] = "static";
+    auto& skeleton = entity.object(entities_io::COMP_SKELETON);
+    skeleton.object("textures")["$0"] = "items:stick";
+    skeleton.list("pose").add(dv::list({
+        1.0, 0.0, 0.0, 0.0,
+        0.0, 1.0, 0.0, 0.0,
+        0.0, 0.0, 1.0, 0.0,
+        0.0, 4.0, 0.0, 1.0,
+    }));
+    entity.object("comps").object("base:drop")["count"] = 3;
+
+    for (bool compress : {false, true}) {
+        auto bytes = json::to_binary(root, compress);
+        auto entities = entities_io::decode(bytes.data(), bytes.size());
+        ASSERT_EQ(entities.size(), 1);
+        const auto& saved = entities[0];
+        EXPECT_EQ(saved.def, "base:drop");
+        EXPECT_EQ(saved.uid, 42);
+        EXPECT_EQ(saved.pos, glm::vec3(1.0f, 2.0f, 3.0f));
+        EXPECT_EQ(saved.size, glm::vec3(0.5f));
+        EXPECT_EQ(saved.rot, glm::mat3(1.0f));
+        EXPECT_EQ(saved.velocity, glm::vec3(0.0f, -1.0f, 0.0f));
+        EXPECT_EQ(saved.damping, 2.5f);
+        EXPECT_EQ(saved.bodyType, BodyType::STATIC);
+        EXPECT_EQ(saved.textures.at("$0"), "items:stick");
+        ASSERT_EQ(saved.pose.size(), 1);
+        EXPECT_EQ(saved.pose[0][3][1], 4.0f);
+        EXPECT_EQ(saved.components["base:drop"]["count"].asInteger(), 3);
+    }
+}
+
+TEST(entities_io, DecodeInvalidBodyType) {
+    SavedEntity entity;
+    entity.def = "base:drop";
+    entity.bodyType = static_cast<BodyType>(100);
+    auto bytes = entities_io::encode({entity});
+
+    auto decoded = entities_io::decode(bytes.data(), bytes.size());
+    ASSERT_EQ(decoded.size(), 1);
+    EXPECT_FALSE(decoded[0].bodyType.has_value());
+}
@@ -0,0 +1,129 @@
+#include "test_utils.hpp"
+
+#include "constants.hpp"
+#include "content/Content.hpp"
+#include "content/ContentBuilder.hpp"
+#include "core_defs.hpp"
+#include "files/WorldFiles.hpp"
+#include "files/engine_paths.hpp"
+#include "items/ItemDef.hpp"
+#include "lighting/Lighting.hpp"
+#include "objects/EntityDef.hpp"
+#include "objects/rigging.hpp"
+#include "settings.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/ChunksStorage.hpp"
+#include "world/Level.hpp"
+#include "world/World.hpp"
+
+using namespace test;
+
+static const std::string CAMERAS[] {
+    "core:first-person",
+    "core:third-person-front",
+    "core:third-person-back",
+};
+
+TempDirectory::TempDirectory(const std::string& name)
+    : path(fs::temp_directory_path() / fs::u8path("voxelengine-test-" + name)) {
+    fs::remove_all(path);
+    fs::create_directories(path);
+}
+
+TempDirectory::~TempDirectory() {
+    std::error_code ec;
+    fs::remove_all(path, ec);
+}
+
+static Block& create_block(ContentBuilder& builder, const std::string& name) {
+    auto& block = builder.blocks.create(name);
+    auto& item = builder.items.create(name + BLOCK_ITEM_SUFFIX);
+    item.placingBlock = name;
+    return block;
+}
+
+std::unique_ptr<Content> test::create_content() {
+    EnginePaths paths;
+    ContentBuilder builder;
+    corecontent::setup(&paths, &builder);
+
+    create_block(builder, STONE);
+    {
+        auto& block = create_block(builder, GLASS);
+        block.drawGroup = 2;
+        block.lightPassing = true;
+        block.skyLightPassing = true;
+    }
+    {
+        auto& block = create_block(builder, LAMP);
+        block.emission[0] = 15;
+        block.emission[1] = 14;
+        block.emission[2] = 13;
+    }
+    {
+        auto& block = create_block(builder, FLOWER);
+        block.model = BlockModel::xsprite;
+        block.lightPassing = true;
+        block.skyLightPassing = true;
+        block.obstacle = false;
+        block.grounded = true;
+    }
+    {
+        auto& block = create_block(builder, BIG);
+        block.size = glm::i8vec3(2, 2, 2);
+    }
+    for (const auto& camera : CAMERAS) {
+        builder.resourceIndices[static_cast<size_t>(ResourceType::CAMERA)].add(
+            camera, nullptr
+        );
+    }
+    return builder.build();
+}
+
+std::unique_ptr<Level> test::create_level(
+    const Content& content, EngineSettings& settings, const fs::path& directory
+) {
+    settings.chunks.loadDistance.set(3);
+    settings.chunks.padding.set(1);
+
+    WorldInfo info {};
+    info.name = "test";
+    info.seed = 0;
+    auto worldFiles = std::make_shared<WorldFiles>(directory);
+    auto world = std::make_unique<World>(
+        std::move(info), worldFiles, &content, std::vector<ContentPack> {}
+    );
+    auto level = std::make_unique<Level>(std::move(world), &content, settings);
+    level->chunks->setCenter(0, 0);
+    return level;
+}
+
+void test::fill_level(Level& level, int radius) {
+    auto stone = level.content->blocks.require(STONE).rt.id;
+    for (int z = -radius; z <= radius; z++) {
+        for (int x = -radius; x <= radius; x++) {
+            auto chunk = level.chunksStorage->create(x, z);
+            for (int i = 0; i < CHUNK_VOL; i++) {
+                int y = i / (CHUNK_W * CHUNK_D);
+                chunk->voxels[i] = voxel {
+                    y < GROUND_HEIGHT ? stone : BLOCK_AIR, {}};
+            }
+            chunk->updateHeights();
+            chunk->flags.loaded = true;
+            chunk->flags.ready = true;
+            level.chunks->putChunk(chunk);
+            Lighting::prebuildSkyLight(
+                chunk.get(), level.content->getIndices()
+            );
+        }
+    }
+    for (int z = -radius + 1; z < radius; z++) {
+        for (int x = -radius + 1; x < radius; x++) {
+            level.lighting->buildSkyLight(x, z);
+            level.lighting->onChunkLoaded(x, z, true);
+            level.chunks->getChunk(x, z)->flags.lighted = true;
+        }
+    }
+}
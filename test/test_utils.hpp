@@ -0,0 +1,55 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "typedefs.hpp"
+
+namespace fs = std::filesystem;
+
+class Content;
+class Level;
+struct EngineSettings;
+
+/// @brief Headless environment for tests: synthetic content and level
+/// created without window, assets and scripting
+namespace test {
+    inline const std::string STONE = "test:stone";
+    inline const std::string GLASS = "test:glass";
+    inline const std::string LAMP = "test:lamp";
+    inline const std::string FLOWER = "test:flower";
+    /// @brief Extended block 2x2x2
+    inline const std::string BIG = "test:big";
+
+    /// @brief Height of the flat stone terrain created by fill_level
+    inline constexpr int GROUND_HEIGHT = 40;
+
+    /// @brief Temporary directory removed with all its content on destruction
+    class TempDirectory {
+        fs::path path;
+    public:
+        TempDirectory(const std::string& name);
+        ~TempDirectory();
+
+        const fs::path& get() const {
+            return path;
+        }
+    };
+
+    /// @brief Create content with core blocks and a few test blocks
+    /// (solid, transparent, emissive, grounded, extended)
+    std::unique_ptr<Content> create_content();
+
+    /// @brief Create level with world files in the given directory.
+    /// Chunks matrix is centered at 0, 0
+    std::unique_ptr<Level> create_level(
+        const Content& content,
+        EngineSettings& settings,
+        const fs::path& directory
+    );
+
+    /// @brief Create level chunks in the square [-radius, radius] filled
+    /// with flat stone terrain and build lights
+    void fill_level(Level& level, int radius);
+}
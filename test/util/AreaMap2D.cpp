@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <atomic>
+#include <map>
+#include <random>
 
 #include "util/AreaMap2D.hpp"
 
@@ -76,3 +78,59 @@ TEST(AreaMap2D, TranslateWithOut) {
     EXPECT_EQ(outside, 15);
     EXPECT_EQ(window.count(), 20);
 }
+
+TEST(AreaMap2D, TranslateKeepsValues) {
+    const int width = 9;
+    const int height = 6;
+    util::AreaMap2D<int> window(width, height);
+    std::map<std::pair<int, int>, int> expected;
+    window.setOutCallback([&expected](int x, int y, int value) {
+        auto found = expected.find({x, y});
+        ASSERT_NE(found, expected.end());
+        EXPECT_EQ(found->second, value);
+        expected.erase(found);
+    });
+    int centerX = 0;
+    int centerY = 0;
+    window.setCenter(centerX, centerY);
+    int next = 1;
+    std::mt19937 random(42);
+    for (int step = 0; step < 200; step++) {
+        // fill empty cells around the center
+        for (int y = -3; y < 3; y++) {
+            for (int x = -4; x < 4; x++) {
+                int px = centerX + x;
+                int py = centerY + y;
+                if (window.get(px, py) == 0 && random() % 2 &&
+                    window.set(px, py, next)) {
+                    expected[{px, py}] = next++;
+                }
+            }
+        }
+        centerX += static_cast<int>(random() % 7) - 3;
+        centerY += static_cast<int>(random() % 5) - 2;
+        if (step % 50 == 49) {
+            centerX += 20;
+        }
+        window.setCenter(centerX, centerY);
+
+        ASSERT_EQ(window.count(), expected.size());
+        for (const auto& [pos, value] : expected) {
+            ASSERT_EQ(window.require(pos.first, pos.second), value);
+        }
+        size_t nonZero = 0;
+        for (int i = 0; i < window.area(); i++) {
+            int value = window[i];
+            if (value == 0) {
+                continue;
+            }
+            nonZero++;
+            int x = window.getOffsetX() + i % width;
+            int y = window.getOffsetY() + i / width;
+            EXPECT_EQ(expected.at({x, y}), value);
+        }
+        EXPECT_EQ(nonZero, expected.size());
+    }
+    window.clear();
+    EXPECT_TRUE(expected.empty());
+}
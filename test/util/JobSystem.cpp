@@ -0,0 +1,75 @@
+#include "util/JobSystem.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "util/ThreadPool.hpp"
+
+TEST(JobSystem, GroupContinuation) {
+    util::JobSystem system(4);
+    std::atomic<int> counter = 0;
+    std::atomic<int> result = -1;
+    util::JobGroup group(system);
+    for (int i = 0; i < 1000; i++) {
+        group.add([&counter]() { counter++; });
+    }
+    group.then([&]() { result = counter.load(); });
+    group.wait();
+    util::JobGroup after(system);
+    after.then([]() {});
+    after.wait();
+    while (result == -1) {
+        system.runPending();
+    }
+    EXPECT_EQ(result, 1000);
+}
+
+TEST(JobSystem, NestedJobs) {
+    util::JobSystem system(3);
+    std::atomic<int> counter = 0;
+    util::JobGroup group(system);
+    for (int i = 0; i < 16; i++) {
+        group.add([&]() {
+            for (int j = 0; j < 16; j++) {
+                group.add([&counter]() { counter++; });
+            }
+        });
+    }
+    group.wait();
+    EXPECT_EQ(counter, 256);
+}
+
+namespace {
+    class SquareWorker : public util::Worker<int, int> {
+    public:
+        int operator()(const int& value) override {
+            return value * value;
+        }
+    };
+}
+
+TEST(JobSystem, ThreadPool) {
+    util::JobSystem system(4);
+    for (bool standalone : {true, false}) {
+        long long sum = 0;
+        bool completed = false;
+        util::ThreadPool<int, int> pool(
+            "test-pool",
+            []() { return std::make_shared<SquareWorker>(); },
+            [&sum](int& result) { sum += result; },
+            2,
+            system
+        );
+        pool.setStandaloneResults(standalone);
+        pool.setOnComplete([&completed]() { completed = true; });
+        for (int i = 1; i <= 100; i++) {
+            pool.enqueueJob(i);
+        }
+        EXPECT_EQ(pool.getWorkersCount(), 2);
+        pool.waitForEnd();
+        EXPECT_TRUE(completed);
+        EXPECT_EQ(sum, 338350);
+        EXPECT_EQ(pool.getWorkDone(), 100);
+    }
+}
@@ -0,0 +1,58 @@
+#include "util/RingQueue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(RingQueue, Bounded) {
+    util::RingQueue<std::string> queue(4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.push(std::to_string(i)));
+    }
+    EXPECT_FALSE(queue.push("overflow"));
+
+    std::string value;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, "0");
+    EXPECT_TRUE(queue.push("4"));
+    for (int i = 1; i <= 4; i++) {
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, std::to_string(i));
+    }
+    EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(RingQueue, MultipleProducers) {
+    const int producers = 4;
+    const int count = 10000;
+    util::RingQueue<int> queue(64);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < count; i++) {
+                while (!queue.push(p * count + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    // values of each producer are received in order
+    std::vector<int> last(producers, -1);
+    int received = 0;
+    while (received < producers * count) {
+        int value;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = value / count;
+        EXPECT_GT(value % count, last[producer]);
+        last[producer] = value % count;
+        received++;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
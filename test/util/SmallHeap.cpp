@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <map>
+
 #include "util/SmallHeap.hpp"
 
 using namespace util;
@@ -82,3 +84,63 @@ TEST(SmallHeap, Iterator) {
     }
     EXPECT_EQ(sum, 44);
 }
+
+TEST(SmallHeap, SerializedOrder) {
+    SmallHeap<uint16_t, uint8_t> map;
+    map.allocate(30, 3);
+    map.allocate(10, 1);
+    map.allocate(20, 2);
+    map.allocate(40, 4);
+    map.free(map.find(20));
+    map.allocate(10, 5);
+    map.find(40)[0] = 42;
+
+    SmallHeap<uint16_t, uint8_t> expected;
+    expected.allocate(10, 5);
+    expected.allocate(30, 3);
+    expected.allocate(40, 4)[0] = 42;
+
+    EXPECT_EQ(map, expected);
+    EXPECT_EQ(map.size(), expected.size());
+    auto bytes = map.serialize();
+    auto expectedBytes = expected.serialize();
+    ASSERT_EQ(bytes.size(), expectedBytes.size());
+    EXPECT_EQ(
+        std::memcmp(bytes.data(), expectedBytes.data(), bytes.size()), 0
+    );
+}
+
+TEST(SmallHeap, RandomFillAndFree) {
+    SmallHeap<uint16_t, uint8_t> map;
+    std::map<int, int> sizes;
+    int n = 1'000;
+    for (int i = 0; i < n * 10; i++) {
+        int index = rand() % n;
+        if (rand() % 3 == 0) {
+            map.free(map.find(index));
+            sizes.erase(index);
+        } else {
+            int size = rand() % 254 + 1;
+            map.allocate(index, size)[size - 1] = index % 256;
+            sizes[index] = size;
+        }
+    }
+    EXPECT_EQ(map.count(), sizes.size());
+    for (const auto& [index, size] : sizes) {
+        auto ptr = map.find(index);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(map.sizeOf(ptr), size);
+        EXPECT_EQ(ptr[size - 1], index % 256);
+    }
+    auto bytes = map.serialize();
+    SmallHeap<uint16_t, uint8_t> out;
+    out.deserialize(bytes.data(), bytes.size());
+    EXPECT_EQ(map, out);
+
+    int previous = -1;
+    for (const auto& entry : out) {
+        EXPECT_GT(entry.index, previous);
+        EXPECT_EQ(entry.size(), sizes[entry.index]);
+        previous = entry.index;
+    }
+}
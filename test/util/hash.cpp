@@ -0,0 +1,23 @@
+#include "util/hash.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(Hasher64, KnownValues) {
+    util::Hasher64 empty;
+    EXPECT_EQ(empty.value(), 0xcbf29ce484222325ULL);
+
+    util::Hasher64 hasher;
+    hasher.update("a", 1);
+    EXPECT_EQ(hasher.value(), 0xaf63dc4c8601ec8cULL);
+}
+
+TEST(Hasher64, StringsSequence) {
+    util::Hasher64 a;
+    a.update(std::string("ab"));
+    a.update(std::string("c"));
+
+    util::Hasher64 b;
+    b.update(std::string("a"));
+    b.update(std::string("bc"));
+    EXPECT_NE(a.value(), b.value());
+}
@@ -1,6 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
+#include "../test_utils.hpp"
+#include "content/Content.hpp"
+#include "settings.hpp"
+#include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "world/Level.hpp"
 
 TEST(Chunk, EncodeDecode) {
     Chunk chunk1(0, 0);
@@ -23,3 +31,158 @@ TEST(Chunk, EncodeDecode) {
         );
     }
 }
+
+static std::unique_ptr<Level> create_test_level(
+    const Content& content,
+    EngineSettings& settings,
+    const test::TempDirectory& directory
+) {
+    auto level = test::create_level(content, settings, directory.get());
+    test::fill_level(*level, 1);
+    return level;
+}
+
+static bool contains(
+    const std::vector<glm::ivec3>& positions, const glm::ivec3& pos
+) {
+    return std::find(positions.begin(), positions.end(), pos) !=
+           positions.end();
+}
+
+TEST(Chunks, SetGetVoxels) {
+    test::TempDirectory directory("chunks-voxels");
+    auto content = test::create_content();
+    EngineSettings settings;
+    auto level = create_test_level(*content, settings, directory);
+    auto& chunks = *level->chunks;
+
+    blockid_t ids[] {
+        content->blocks.require(test::STONE).rt.id,
+        content->blocks.require(test::GLASS).rt.id,
+        content->blocks.require(test::LAMP).rt.id,
+        BLOCK_AIR,
+    };
+    // box crossing chunk borders by x and z
+    glm::ivec3 start(CHUNK_W - 3, test::GROUND_HEIGHT - 2, -2);
+    glm::ivec3 size(6, 4, 5);
+    std::vector<voxel> voxels(size.x * size.y * size.z);
+    size_t expectedChanges = 0;
+    for (int y = 0; y < size.y; y++) {
+        for (int z = 0; z < size.z; z++) {
+            for (int x = 0; x < size.x; x++) {
+                auto& vox = voxels[vox_index(x, y, z, size.x, size.z)];
+                vox = voxel {ids[(x + y * 3 + z * 7) % 4], {}};
+                auto pos = start + glm::ivec3(x, y, z);
+                if (chunks.require(pos.x, pos.y, pos.z).id != vox.id) {
+                    expectedChanges++;
+                }
+            }
+        }
+    }
+    std::vector<glm::ivec3> changed;
+    chunks.setVoxels(start, size, voxels.data(), changed);
+    EXPECT_EQ(changed.size(), expectedChanges);
+
+    std::vector<voxel> result(voxels.size());
+    std::vector<light_t> lights(voxels.size());
+    chunks.getVoxels(start, size, result.data(), lights.data());
+    for (int y = 0; y < size.y; y++) {
+        for (int z = 0; z < size.z; z++) {
+            for (int x = 0; x < size.x; x++) {
+                size_t index = vox_index(x, y, z, size.x, size.z);
+                auto pos = start + glm::ivec3(x, y, z);
+                EXPECT_EQ(result[index].id, voxels[index].id);
+                EXPECT_EQ(chunks.require(pos.x, pos.y, pos.z).id,
+                          voxels[index].id);
+            }
+        }
+    }
+
+    // the same voxels set again change nothing
+    changed.clear();
+    chunks.setVoxels(start, size, voxels.data(), changed);
+    EXPECT_TRUE(changed.empty());
+}
+
+TEST(Chunks, VoxelsOutOfArea) {
+    test::TempDirectory directory("chunks-voxels-area");
+    auto content = test::create_content();
+    EngineSettings settings;
+    auto level = create_test_level(*content, settings, directory);
+    auto& chunks = *level->chunks;
+    auto glass = content->blocks.require(test::GLASS).rt.id;
+
+    // chunk 2, 0 is not loaded, y below 0 is out of range
+    glm::ivec3 start(CHUNK_W * 2 - 2, -2, 0);
+    glm::ivec3 size(4, 4, 1);
+    std::vector<voxel> voxels(size.x * size.y * size.z, voxel {glass, {}});
+    std::vector<glm::ivec3> changed;
+    chunks.setVoxels(start, size, voxels.data(), changed);
+    ASSERT_EQ(changed.size(), 4);
+    for (const auto& pos : changed) {
+        EXPECT_LT(pos.x, CHUNK_W * 2);
+        EXPECT_GE(pos.y, 0);
+    }
+
+    std::vector<voxel> result(voxels.size());
+    std::vector<light_t> lights(voxels.size(), 0xFFFF);
+    chunks.getVoxels(start, size, result.data(), lights.data());
+    for (int y = 0; y < size.y; y++) {
+        for (int x = 0; x < size.x; x++) {
+            size_t index = vox_index(x, y, 0, size.x, size.z);
+            bool inside = start.x + x < CHUNK_W * 2 && start.y + y >= 0;
+            EXPECT_EQ(result[index].id, inside ? glass : BLOCK_VOID);
+            if (!inside) {
+                EXPECT_EQ(lights[index], 0);
+            }
+        }
+    }
+
+    // void voxels are skipped
+    changed.clear();
+    std::vector<voxel> voids(voxels.size(), voxel {BLOCK_VOID, {}});
+    chunks.setVoxels(start, size, voids.data(), changed);
+    EXPECT_TRUE(changed.empty());
+}
+
+TEST(Chunks, SetVoxelsExtendedBlock) {
+    test::TempDirectory directory("chunks-voxels-extended");
+    auto content = test::create_content();
+    EngineSettings settings;
+    auto level = create_test_level(*content, settings, directory);
+    auto& chunks = *level->chunks;
+    const auto& big = content->blocks.require(test::BIG);
+
+    // origin at the chunk corner, segments are placed to 4 chunks
+    glm::ivec3 origin(CHUNK_W - 1, test::GROUND_HEIGHT, CHUNK_D - 1);
+    voxel vox {big.rt.id, {}};
+    std::vector<glm::ivec3> changed;
+    chunks.setVoxels(origin, glm::ivec3(1), &vox, changed);
+    EXPECT_EQ(changed.size(), 8);
+    for (int y = 0; y < 2; y++) {
+        for (int z = 0; z < 2; z++) {
+            for (int x = 0; x < 2; x++) {
+                auto pos = origin + glm::ivec3(x, y, z);
+                EXPECT_TRUE(contains(changed, pos));
+                const auto& segment = chunks.require(pos.x, pos.y, pos.z);
+                EXPECT_EQ(segment.id, big.rt.id);
+                EXPECT_EQ(segment.state.segment != 0, (x | y | z) != 0);
+            }
+        }
+    }
+
+    // replacing the origin erases segments
+    vox = voxel {BLOCK_AIR, {}};
+    changed.clear();
+    chunks.setVoxels(origin, glm::ivec3(1), &vox, changed);
+    EXPECT_EQ(changed.size(), 8);
+    for (int y = 0; y < 2; y++) {
+        for (int z = 0; z < 2; z++) {
+            for (int x = 0; x < 2; x++) {
+                auto pos = origin + glm::ivec3(x, y, z);
+                EXPECT_TRUE(contains(changed, pos));
+                EXPECT_EQ(chunks.require(pos.x, pos.y, pos.z).id, BLOCK_AIR);
+            }
+        }
+    }
+}
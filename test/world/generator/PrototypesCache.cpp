@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "world/generator/PrototypesCache.hpp"
+
+static fs::path prepare_folder() {
+    auto folder = fs::temp_directory_path() / "ve_test_prototypes_cache";
+    fs::remove_all(folder);
+    return folder;
+}
+
+static void fill(PrototypesCache& cache, int x, int z) {
+    cache.setWideStructs(
+        x, z, {Placement(1, StructurePlacement(x, {z, 2, 3}, 1))}
+    );
+    cache.setBiomes(x, z, std::vector<uint16_t>(256, x & 0xFF));
+    cache.setHeights(x, z, std::vector<float>(256, z * 0.5f));
+    cache.setStructures(
+        x, z, {Placement(2, LinePlacement(5, {x, 0, z}, {0, 1, 2}, 3))}
+    );
+}
+
+static void check(const CachedPrototype* prototype, int x, int z) {
+    ASSERT_NE(prototype, nullptr);
+    ASSERT_TRUE(prototype->wideStructs.has_value());
+    ASSERT_EQ(prototype->wideStructs->size(), 1);
+    const auto& placement = prototype->wideStructs->at(0);
+    EXPECT_EQ(placement.priority, 1);
+    const auto& sp = std::get<StructurePlacement>(placement.placement);
+    EXPECT_EQ(sp.structure, x);
+    EXPECT_EQ(sp.position, glm::ivec3(z, 2, 3));
+    EXPECT_EQ(sp.rotation, 1);
+
+    ASSERT_EQ(prototype->biomes.size(), 256);
+    EXPECT_EQ(prototype->biomes[100], x & 0xFF);
+    ASSERT_EQ(prototype->heights.size(), 256);
+    EXPECT_EQ(prototype->heights[255], z * 0.5f);
+
+    ASSERT_TRUE(prototype->structures.has_value());
+    ASSERT_EQ(prototype->structures->size(), 1);
+    const auto& line =
+        std::get<LinePlacement>(prototype->structures->at(0).placement);
+    EXPECT_EQ(line.block, 5);
+    EXPECT_EQ(line.a, glm::ivec3(x, 0, z));
+    EXPECT_EQ(line.radius, 3);
+}
+
+TEST(PrototypesCache, MemoryBudget) {
+    PrototypesCache cache(16 * 1024, 1, std::nullopt);
+    for (int i = 0; i < 100; i++) {
+        fill(cache, i, -i);
+    }
+    cache.trim();
+    // trimmed below the budget to not evict on every call
+    EXPECT_LE(cache.getMemoryUsage(), 12 * 1024);
+    EXPECT_LT(cache.size(), 100);
+    // least recently used entries are evicted first
+    check(cache.get(99, -99), 99, -99);
+    EXPECT_EQ(cache.get(0, 0), nullptr);
+}
+
+TEST(PrototypesCache, Spill) {
+    auto folder = prepare_folder();
+    {
+        PrototypesCache cache(16 * 1024, 1, folder);
+        for (int z = -20; z < 20; z++) {
+            for (int x = -20; x < 20; x++) {
+                fill(cache, x, z);
+            }
+            cache.trim();
+        }
+        EXPECT_LE(cache.getMemoryUsage(), 16 * 1024);
+        check(cache.get(-20, -20), -20, -20);
+        check(cache.get(19, 0), 19, 0);
+        EXPECT_EQ(cache.get(100, 100), nullptr);
+    }
+    {
+        PrototypesCache cache(16 * 1024, 1, folder);
+        for (int z = -20; z < 20; z++) {
+            for (int x = -20; x < 20; x++) {
+                check(cache.get(x, z), x, z);
+            }
+            cache.trim();
+        }
+    }
+    {
+        PrototypesCache cache(16 * 1024, 2, folder);
+        EXPECT_EQ(cache.get(0, 0), nullptr);
+    }
+    fs::remove_all(folder);
+}